@@ -0,0 +1,26 @@
+# Runs tfs_simulation twice with the same seed and fails unless both runs end
+# with the same world digest. Invoked by the tfs_simulation_check target.
+#
+# SIMULATION - path of the tfs_simulation binary
+# ARGUMENTS  - semicolon separated arguments passed to both runs
+
+foreach(run 1 2)
+    execute_process(
+        COMMAND ${SIMULATION} ${ARGUMENTS}
+        OUTPUT_VARIABLE output
+        RESULT_VARIABLE result
+    )
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "tfs_simulation run ${run} failed:\n${output}")
+    endif()
+
+    string(REGEX MATCH "world digest: [0-9a-f]+" digest${run} "${output}")
+    if(NOT digest${run})
+        message(FATAL_ERROR "tfs_simulation run ${run} printed no world digest:\n${output}")
+    endif()
+endforeach()
+
+if(NOT digest1 STREQUAL digest2)
+    message(FATAL_ERROR "Runs with the same seed diverged: ${digest1} and ${digest2}")
+endif()
+message(STATUS "Both runs ended with ${digest1}")
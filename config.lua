@@ -19,11 +19,14 @@ expFromPlayersLevelRange = 75
 -- Connection Config
 -- NOTE: maxPlayers set to 0 means no limit
 -- NOTE: allowWalkthrough is only applicable to players
+-- NOTE: metricsProtocolPort 0 disables the metrics exporter, it only listens
+-- on 127.0.0.1 and answers with the metrics in the Prometheus text format
 ip = "167.114.185.25"
 bindOnlyGlobalAddress = false
 loginProtocolPort = 7171
 gameProtocolPort = 7172
 statusProtocolPort = 7171
+metricsProtocolPort = 0
 maxPlayers = 0
 motd = "Welcome to The Forgotten Server!"
 onePlayerOnlinePerAccount = true
@@ -34,6 +37,42 @@ statusTimeout = 5000
 replaceKickOnLogin = true
 maxPacketsPerSecond = 25
 
+-- Compression
+-- NOTE: compressionLevel 0 disables compression, 1-9 are deflate levels
+-- NOTE: only clients that request compression receive compressed messages,
+-- messages smaller than compressionThreshold bytes are always sent raw
+-- NOTE: compressionOpcode is the extended opcode a client sends to request
+-- compression, while compression is enabled it is reserved and never reaches
+-- onExtendedOpcode scripts
+compressionLevel = 0
+compressionThreshold = 128
+compressionOpcode = 255
+
+-- Player updates
+-- NOTE: stat and skill changes are merged into one update per dispatcher cycle,
+-- by default as the full 0xA0/0xA1 packets every client understands
+-- NOTE: with playerUpdateDeltas a client that sends the extended opcode
+-- playerUpdateOpcode receives only the changed fields in 0xBA/0xBB packets,
+-- the opcode is then reserved and never reaches onExtendedOpcode scripts
+playerUpdateDeltas = false
+playerUpdateOpcode = 254
+
+-- Login decryption
+-- NOTE: cryptoThreads is the number of worker threads decrypting the RSA block
+-- of new login and game connections, 0 decrypts on the network thread
+cryptoThreads = 2
+
+-- Worker threads
+-- NOTE: workerThreads helps the dispatcher with read-only work such as monster
+-- path searches during creature thinking, 0 keeps everything on the dispatcher
+workerThreads = 2
+
+-- Lag watchdog
+-- NOTE: a dispatcher task running longer than lagWatchdogThreshold milliseconds
+-- is logged to lagspikes.log with its type, player, Lua script and stack,
+-- 0 disables the watchdog
+lagWatchdogThreshold = 0
+
 -- Deaths
 -- NOTE: Leave deathLosePercent as -1 if you want to use the default
 -- death penalty formula. For the old formula, set it to 10. For
@@ -2,13 +2,13 @@ function Container.isContainer(self)
 	return true
 end
 
-function Container.createLootItem(self, item)
+function Container.createLootItem(self, item, randvalue)
 	if self:getEmptySlots() == 0 then
 		return true
 	end
 
 	local itemCount = 0
-	local randvalue = getLootRandom()
+	randvalue = randvalue or getLootRandom()
 	if randvalue < item.chance then
 		if ItemType(item.itemId):isStackable() then
 			itemCount = randvalue % item.maxCount + 1
@@ -9,8 +9,10 @@ ec.onDropLoot = function(self, corpse)
 	local mType = self:getType()
 	if not player or player:getStamina() > 840 then
 		local monsterLoot = mType:getLoot()
+		local rolls = Game.getRandomValues(#monsterLoot, 0, MAX_LOOTCHANCE)
+		local rate = configManager.getNumber(configKeys.RATE_LOOT)
 		for i = 1, #monsterLoot do
-			local item = corpse:createLootItem(monsterLoot[i])
+			local item = corpse:createLootItem(monsterLoot[i], rolls[i] / rate)
 			if not item then
 				print('[Warning] DropLoot:', 'Could not add loot item to corpse.')
 			end
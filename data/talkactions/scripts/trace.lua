@@ -0,0 +1,17 @@
+function onSay(player, words, param)
+	if not player:getGroup():getAccess() then
+		return true
+	end
+
+	if player:getAccountType() < ACCOUNT_TYPE_GOD then
+		return false
+	end
+
+	local seconds = math.min(math.max(tonumber(param) or 5, 1), 60)
+	if Game.startTrace(seconds * 1000) then
+		player:sendTextMessage(MESSAGE_STATUS_CONSOLE_BLUE, "Tracing for " .. seconds .. " seconds, the trace file is written to the server directory.")
+	else
+		player:sendTextMessage(MESSAGE_STATUS_CONSOLE_BLUE, "A trace is already running.")
+	end
+	return false
+end
@@ -229,6 +229,7 @@ void BedItem::regeneratePlayer(Player* player) const
 				player->removeCondition(condition);
 			} else {
 				condition->setTicks(newRegenTicks);
+				player->scheduleCondition(condition);
 			}
 		} else {
 			regen = sleptTime / 30;
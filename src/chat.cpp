@@ -55,8 +55,10 @@ void PrivateChatChannel::invitePlayer(const Player& player, Player& invitePlayer
 	ss << invitePlayer.getName() << " has been invited.";
 	player.sendTextMessage(MESSAGE_INFO_DESCR, ss.str());
 
-	for (const auto& it : users) {
-		it.second->sendChannelEvent(id, invitePlayer.getName(), CHANNELEVENT_INVITE);
+	NetworkMessage msg;
+	ProtocolGame::AddChannelEvent(msg, id, invitePlayer.getName(), CHANNELEVENT_INVITE);
+	for (Player* user : users) {
+		user->sendNetworkMessage(msg);
 	}
 }
 
@@ -74,21 +76,32 @@ void PrivateChatChannel::excludePlayer(const Player& player, Player& excludePlay
 
 	excludePlayer.sendClosePrivate(id);
 
-	for (const auto& it : users) {
-		it.second->sendChannelEvent(id, excludePlayer.getName(), CHANNELEVENT_EXCLUDE);
+	NetworkMessage msg;
+	ProtocolGame::AddChannelEvent(msg, id, excludePlayer.getName(), CHANNELEVENT_EXCLUDE);
+	for (Player* user : users) {
+		user->sendNetworkMessage(msg);
 	}
 }
 
 void PrivateChatChannel::closeChannel() const
 {
-	for (const auto& it : users) {
-		it.second->sendClosePrivate(id);
+	for (Player* user : users) {
+		user->sendClosePrivate(id);
 	}
 }
 
+UsersList::const_iterator ChatChannel::findUser(uint32_t playerId) const
+{
+	auto it = std::lower_bound(users.begin(), users.end(), playerId, [](const Player* user, uint32_t playerId) { return user->getID() < playerId; });
+	if (it != users.end() && (*it)->getID() == playerId) {
+		return it;
+	}
+	return users.end();
+}
+
 bool ChatChannel::addUser(Player& player)
 {
-	if (users.find(player.getID()) != users.end()) {
+	if (hasUser(player)) {
 		return false;
 	}
 
@@ -105,18 +118,21 @@ bool ChatChannel::addUser(Player& player)
 	}
 
 	if (!publicChannel) {
-		for (const auto& it : users) {
-			it.second->sendChannelEvent(id, player.getName(), CHANNELEVENT_JOIN);
+		NetworkMessage msg;
+		ProtocolGame::AddChannelEvent(msg, id, player.getName(), CHANNELEVENT_JOIN);
+		for (Player* user : users) {
+			user->sendNetworkMessage(msg);
 		}
 	}
 
-	users[player.getID()] = &player;
+	uint32_t playerId = player.getID();
+	users.insert(std::lower_bound(users.begin(), users.end(), playerId, [](const Player* user, uint32_t playerId) { return user->getID() < playerId; }), &player);
 	return true;
 }
 
 bool ChatChannel::removeUser(const Player& player)
 {
-	auto iter = users.find(player.getID());
+	auto iter = findUser(player.getID());
 	if (iter == users.end()) {
 		return false;
 	}
@@ -124,8 +140,10 @@ bool ChatChannel::removeUser(const Player& player)
 	users.erase(iter);
 
 	if (!publicChannel) {
-		for (const auto& it : users) {
-			it.second->sendChannelEvent(id, player.getName(), CHANNELEVENT_LEAVE);
+		NetworkMessage msg;
+		ProtocolGame::AddChannelEvent(msg, id, player.getName(), CHANNELEVENT_LEAVE);
+		for (Player* user : users) {
+			user->sendNetworkMessage(msg);
 		}
 	}
 
@@ -134,24 +152,29 @@ bool ChatChannel::removeUser(const Player& player)
 }
 
 bool ChatChannel::hasUser(const Player& player) {
-	return users.find(player.getID()) != users.end();
+	return findUser(player.getID()) != users.end();
 }
 
 void ChatChannel::sendToAll(const std::string& message, SpeakClasses type) const
 {
-	for (const auto& it : users) {
-		it.second->sendChannelMessage("", message, type, id);
+	NetworkMessage msg;
+	ProtocolGame::AddChannelMessage(msg, "", message, type, id);
+	for (Player* user : users) {
+		user->sendNetworkMessage(msg);
 	}
 }
 
 bool ChatChannel::talk(const Player& fromPlayer, SpeakClasses type, const std::string& text)
 {
-	if (users.find(fromPlayer.getID()) == users.end()) {
+	if (!hasUser(fromPlayer)) {
 		return false;
 	}
 
-	for (const auto& it : users) {
-		it.second->sendToChannel(&fromPlayer, type, text, id);
+	// every member receives the same bytes, so the message is built once
+	NetworkMessage msg;
+	ProtocolGame::AddToChannel(msg, &fromPlayer, type, text, id);
+	for (Player* user : users) {
+		user->sendNetworkMessage(msg);
 	}
 	return true;
 }
@@ -317,9 +340,10 @@ bool Chat::load()
 				}
 			}
 
-			UsersMap tempUserMap = std::move(channel.users);
-			for (const auto& pair : tempUserMap) {
-				channel.addUser(*pair.second);
+			UsersList tempUsers = std::move(channel.users);
+			channel.users.clear();
+			for (Player* user : tempUsers) {
+				channel.addUser(*user);
 			}
 			continue;
 		}
@@ -0,0 +1,283 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "tools.h"
+
+namespace {
+
+struct RandomCheckOptions
+{
+	uint32_t draws = 1000000;
+	uint64_t seed = 1;
+};
+
+bool parseArgument(const std::string& arg, RandomCheckOptions& options)
+{
+	auto separator = arg.find('=');
+	if (arg.compare(0, 2, "--") != 0 || separator == std::string::npos) {
+		return false;
+	}
+
+	const std::string name = arg.substr(2, separator - 2);
+	const std::string value = arg.substr(separator + 1);
+	try {
+		if (name == "draws") {
+			options.draws = std::max<uint32_t>(1000, std::stoul(value));
+		} else if (name == "seed") {
+			options.seed = std::stoull(value);
+		} else {
+			return false;
+		}
+	} catch (const std::exception&) {
+		return false;
+	}
+	return true;
+}
+
+void printUsage()
+{
+	std::cout << "Usage: tfs_randomcheck [--option=value...]\n"
+	          << "  --draws                     draws per check and benchmark (1000000)\n"
+	          << "  --seed                      seed of the checked stream (1)\n";
+}
+
+uint32_t fail(const std::string& message)
+{
+	std::cout << "> FAIL: " << message << std::endl;
+	return 1;
+}
+
+// critical chi-square value for p = 0.001, Wilson-Hilferty approximation
+double chiSquareLimit(uint32_t degrees)
+{
+	const double z = 3.09;
+	const double a = 2.0 / (9.0 * degrees);
+	return degrees * std::pow(1.0 - a + z * std::sqrt(a), 3);
+}
+
+uint32_t checkChiSquare(const RandomCheckOptions& options, int32_t minNumber, int32_t maxNumber, bool fill)
+{
+	const uint32_t buckets = maxNumber - minNumber + 1;
+	std::vector<uint64_t> counts(buckets);
+	std::vector<int32_t> values(fill ? options.draws : 0);
+	if (fill) {
+		uniform_random_fill(values.data(), values.size(), minNumber, maxNumber);
+	}
+
+	for (uint32_t i = 0; i < options.draws; ++i) {
+		const int32_t value = fill ? values[i] : uniform_random(minNumber, maxNumber);
+		if (value < minNumber || value > maxNumber) {
+			return fail("uniform_random(" + std::to_string(minNumber) + ", " + std::to_string(maxNumber) + ") returned " + std::to_string(value));
+		}
+		++counts[value - minNumber];
+	}
+
+	const double expected = static_cast<double>(options.draws) / buckets;
+	double chiSquare = 0;
+	for (uint64_t count : counts) {
+		chiSquare += (count - expected) * (count - expected) / expected;
+	}
+
+	const double limit = chiSquareLimit(buckets - 1);
+	std::cout << "  " << (fill ? "uniform_random_fill" : "uniform_random") << '(' << minNumber << ", " << maxNumber << ") chi-square "
+	          << std::fixed << std::setprecision(1) << chiSquare << " (limit " << limit << ')' << std::endl;
+	if (chiSquare > limit) {
+		return fail("distribution is not uniform");
+	}
+	return 0;
+}
+
+uint32_t checkEndpoints(const RandomCheckOptions& options)
+{
+	uint32_t failures = 0;
+
+	// the full range is wider than 32 bits of range and skips the rejection step
+	bool negative = false, positive = false;
+	for (uint32_t i = 0; i < options.draws && !(negative && positive); ++i) {
+		const int32_t value = uniform_random(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max());
+		negative |= value < 0;
+		positive |= value > 0;
+	}
+	if (!negative || !positive) {
+		failures += fail("uniform_random over the full int32 range only returned one sign");
+	}
+
+	const std::pair<int32_t, int32_t> ranges[] = {
+		{std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min() + 1},
+		{std::numeric_limits<int32_t>::max() - 1, std::numeric_limits<int32_t>::max()},
+		{100, 1},
+	};
+	for (const auto& range : ranges) {
+		const int32_t low = std::min(range.first, range.second);
+		const int32_t high = std::max(range.first, range.second);
+		bool hitLow = false, hitHigh = false;
+		for (uint32_t i = 0; i < options.draws; ++i) {
+			const int32_t value = uniform_random(range.first, range.second);
+			if (value < low || value > high) {
+				failures += fail("uniform_random(" + std::to_string(range.first) + ", " + std::to_string(range.second) + ") returned " + std::to_string(value));
+				break;
+			}
+			hitLow |= value == low;
+			hitHigh |= value == high;
+		}
+		if (!hitLow || !hitHigh) {
+			failures += fail("uniform_random(" + std::to_string(range.first) + ", " + std::to_string(range.second) + ") never returned an endpoint");
+		}
+	}
+
+	if (uniform_random(7, 7) != 7) {
+		failures += fail("uniform_random(7, 7) is not 7");
+	}
+	return failures;
+}
+
+uint32_t checkBoolean(const RandomCheckOptions& options)
+{
+	uint32_t failures = 0;
+	uint32_t never = 0, always = 0, half = 0;
+	for (uint32_t i = 0; i < options.draws; ++i) {
+		never += boolean_random(0.0);
+		always += boolean_random(1.0);
+		half += boolean_random(0.5);
+	}
+
+	if (never != 0) {
+		failures += fail("boolean_random(0.0) returned true " + std::to_string(never) + " times");
+	}
+	if (always != options.draws) {
+		failures += fail("boolean_random(1.0) returned false " + std::to_string(options.draws - always) + " times");
+	}
+
+	// six standard deviations of the binomial distribution
+	const double deviation = std::abs(half - options.draws / 2.0);
+	if (deviation > 6 * std::sqrt(options.draws / 4.0)) {
+		failures += fail("boolean_random(0.5) returned true " + std::to_string(half) + " times");
+	}
+	return failures;
+}
+
+uint32_t checkDeterminism(const RandomCheckOptions& options)
+{
+	const size_t count = 10000;
+	std::vector<int32_t> first(count), second(count), filled(count);
+
+	seedRandomGenerator(options.seed);
+	for (int32_t& value : first) {
+		value = uniform_random(-1000, 1000);
+	}
+
+	seedRandomGenerator(options.seed);
+	for (int32_t& value : second) {
+		value = uniform_random(-1000, 1000);
+	}
+
+	seedRandomGenerator(options.seed);
+	uniform_random_fill(filled.data(), filled.size(), -1000, 1000);
+
+	uint32_t failures = 0;
+	if (first != second) {
+		failures += fail("the same seed produced different sequences");
+	}
+	if (first != filled) {
+		failures += fail("uniform_random_fill differs from the same number of uniform_random calls");
+	}
+	return failures;
+}
+
+template <typename Draw>
+void benchmark(const std::string& name, uint32_t draws, Draw draw)
+{
+	int64_t sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	draw(sink);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+	          << seconds * 1e9 / draws << " ns/draw (checksum " << sink << ')' << std::endl;
+}
+
+void benchmarkGenerators(const RandomCheckOptions& options)
+{
+	std::cout << ">> Benchmark, " << options.draws << " draws in [1, 100]" << std::endl;
+
+	// the shared generator uniform_random used before, one distribution call per draw
+	benchmark("mt19937 (previous)", options.draws, [&](int64_t& sink) {
+		static std::mt19937 generator(std::random_device{}());
+		static std::uniform_int_distribution<int32_t> uniformRand;
+		for (uint32_t i = 0; i < options.draws; ++i) {
+			sink += uniformRand(generator, std::uniform_int_distribution<int32_t>::param_type(1, 100));
+		}
+	});
+
+	benchmark("uniform_random", options.draws, [&](int64_t& sink) {
+		for (uint32_t i = 0; i < options.draws; ++i) {
+			sink += uniform_random(1, 100);
+		}
+	});
+
+	benchmark("uniform_random_fill", options.draws, [&](int64_t& sink) {
+		std::vector<int32_t> values(1024);
+		for (uint32_t i = 0; i < options.draws; i += values.size()) {
+			const size_t count = std::min<size_t>(values.size(), options.draws - i);
+			uniform_random_fill(values.data(), count, 1, 100);
+			for (size_t j = 0; j < count; ++j) {
+				sink += values[j];
+			}
+		}
+	});
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	RandomCheckOptions options;
+	for (int i = 1; i < argc; ++i) {
+		if (!parseArgument(argv[i], options)) {
+			std::cout << "Unknown or invalid argument " << argv[i] << '.' << std::endl;
+			printUsage();
+			return 1;
+		}
+	}
+
+	seedRandomGenerator(options.seed);
+
+	std::cout << ">> Chi-square over " << options.draws << " draws" << std::endl;
+	uint32_t failures = 0;
+	const std::pair<int32_t, int32_t> ranges[] = {{0, 1}, {1, 6}, {1, 100}, {-3, 3}};
+	for (const auto& range : ranges) {
+		failures += checkChiSquare(options, range.first, range.second, false);
+		failures += checkChiSquare(options, range.first, range.second, true);
+	}
+
+	std::cout << ">> Endpoints, boolean_random and seeding" << std::endl;
+	failures += checkEndpoints(options);
+	failures += checkBoolean(options);
+	failures += checkDeterminism(options);
+
+	if (failures != 0) {
+		std::cout << "> " << failures << " check(s) failed." << std::endl;
+		return 1;
+	}
+	std::cout << ">> All checks passed." << std::endl;
+
+	benchmarkGenerators(options);
+	return 0;
+}
@@ -0,0 +1,228 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "rsa.h"
+
+#include <cryptopp/osrng.h>
+
+#include <array>
+#include <random>
+
+namespace {
+
+struct RsaCheckOptions
+{
+	std::string keyFile = "key.pem";
+	uint32_t rounds = 1000;
+	uint32_t threads = std::max<uint32_t>(1, std::thread::hardware_concurrency());
+	uint32_t duration = 2000;
+	uint32_t seed = 1;
+};
+
+using Block = std::array<char, 128>;
+
+bool parseArgument(const std::string& arg, RsaCheckOptions& options)
+{
+	auto separator = arg.find('=');
+	if (arg.compare(0, 2, "--") != 0 || separator == std::string::npos) {
+		return false;
+	}
+
+	const std::string name = arg.substr(2, separator - 2);
+	const std::string value = arg.substr(separator + 1);
+	try {
+		if (name == "key") {
+			options.keyFile = value;
+		} else if (name == "rounds") {
+			options.rounds = std::stoul(value);
+		} else if (name == "threads") {
+			options.threads = std::max<uint32_t>(1, std::stoul(value));
+		} else if (name == "duration") {
+			options.duration = std::stoul(value);
+		} else if (name == "seed") {
+			options.seed = std::stoul(value);
+		} else {
+			return false;
+		}
+	} catch (const std::exception&) {
+		return false;
+	}
+	return true;
+}
+
+void printUsage()
+{
+	std::cout << "Usage: tfs_rsacheck [--option=value...]\n"
+	          << "  --key                       server RSA key (key.pem)\n"
+	          << "  --rounds                    random blocks compared against CalculateInverse (1000)\n"
+	          << "  --threads                   benchmark 1 up to this many cryptoThreads (hardware threads)\n"
+	          << "  --duration                  milliseconds to benchmark each thread count (2000)\n"
+	          << "  --seed                      seed for the random plaintexts (1)\n";
+}
+
+CryptoPP::Integer toInteger(const Block& block)
+{
+	return CryptoPP::Integer{reinterpret_cast<const uint8_t*>(block.data()), block.size()};
+}
+
+// decrypts the block with the reference implementation, false if Crypto++ rejects it
+bool referenceDecrypt(const RSA& rsa, CryptoPP::RandomNumberGenerator& rng, Block& block)
+{
+	try {
+		CryptoPP::Integer m = rsa.getPrivateKey().CalculateInverse(rng, toInteger(block));
+		m.Encode(reinterpret_cast<uint8_t*>(block.data()), block.size());
+		return true;
+	} catch (const CryptoPP::Exception&) {
+		return false;
+	}
+}
+
+// every round runs on this thread, so the blinding factors are refreshed every BLINDING_REFRESH_INTERVAL rounds
+uint32_t checkRandomBlocks(const RSA& rsa, CryptoPP::RandomNumberGenerator& rng, const RsaCheckOptions& options)
+{
+	std::mt19937 generator{options.seed};
+	std::uniform_int_distribution<int> byte{0, 255};
+
+	uint32_t failures = 0;
+	for (uint32_t round = 0; round < options.rounds; ++round) {
+		// a leading zero keeps the plaintext below n, like the blocks clients send
+		Block plaintext;
+		plaintext[0] = 0;
+		for (size_t i = 1; i < plaintext.size(); ++i) {
+			plaintext[i] = static_cast<char>(byte(generator));
+		}
+
+		Block ciphertext = plaintext;
+		rsa.encrypt(ciphertext.data());
+
+		Block expected = ciphertext;
+		if (!referenceDecrypt(rsa, rng, expected)) {
+			std::cout << "> FAIL: round " << round << " rejected by CalculateInverse." << std::endl;
+			++failures;
+			continue;
+		}
+
+		Block decrypted = ciphertext;
+		rsa.decrypt(decrypted.data());
+		if (decrypted != expected || decrypted != plaintext) {
+			std::cout << "> FAIL: round " << round << " differs from CalculateInverse." << std::endl;
+			++failures;
+		}
+	}
+	return failures;
+}
+
+// a block >= n is not a valid ciphertext, decrypt must reject it like CalculateInverse and leave it untouched
+uint32_t checkCiphertextAboveModulus(const RSA& rsa, CryptoPP::RandomNumberGenerator& rng)
+{
+	Block ciphertext;
+	ciphertext.fill(static_cast<char>(0xFF));
+	if (!(toInteger(ciphertext) >= rsa.getPrivateKey().GetModulus())) {
+		std::cout << "> FAIL: test block is not above the modulus." << std::endl;
+		return 1;
+	}
+
+	Block expected = ciphertext;
+	bool accepted = referenceDecrypt(rsa, rng, expected);
+
+	std::cout << ">> Decrypting a block above the modulus, an error is expected:" << std::endl;
+	Block decrypted = ciphertext;
+	rsa.decrypt(decrypted.data());
+
+	if (accepted ? decrypted != expected : decrypted != ciphertext) {
+		std::cout << "> FAIL: block above the modulus differs from CalculateInverse." << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+void benchmark(const RSA& rsa, const RsaCheckOptions& options)
+{
+	Block ciphertext{};
+	ciphertext[127] = 1;
+	rsa.encrypt(ciphertext.data());
+
+	std::cout << ">> Decrypts per second by cryptoThreads" << std::endl;
+	std::cout << std::fixed << std::setprecision(0);
+	for (uint32_t threadCount = 1; threadCount <= options.threads; ++threadCount) {
+		std::atomic<bool> running{true};
+		std::atomic<uint64_t> decrypts{0};
+
+		std::vector<std::thread> threads;
+		for (uint32_t i = 0; i < threadCount; ++i) {
+			threads.emplace_back([&]() {
+				uint64_t count = 0;
+				while (running.load(std::memory_order_relaxed)) {
+					Block block = ciphertext;
+					rsa.decrypt(block.data());
+					++count;
+				}
+				decrypts.fetch_add(count, std::memory_order_relaxed);
+			});
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		std::this_thread::sleep_for(std::chrono::milliseconds(options.duration));
+		running = false;
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << std::setw(4) << threadCount << std::setw(12) << decrypts / seconds << std::endl;
+	}
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	RsaCheckOptions options;
+	for (int i = 1; i < argc; ++i) {
+		if (!parseArgument(argv[i], options)) {
+			std::cout << "Unknown or invalid argument " << argv[i] << '.' << std::endl;
+			printUsage();
+			return 1;
+		}
+	}
+
+	RSA rsa;
+	try {
+		rsa.loadPEM(options.keyFile);
+	} catch (const std::exception& e) {
+		std::cout << "> ERROR: " << e.what() << std::endl;
+		return 1;
+	}
+
+	CryptoPP::AutoSeededRandomPool rng;
+
+	std::cout << ">> Comparing " << options.rounds << " random blocks against CalculateInverse" << std::endl;
+	uint32_t failures = checkRandomBlocks(rsa, rng, options);
+	failures += checkCiphertextAboveModulus(rsa, rng);
+	if (failures != 0) {
+		std::cout << "> " << failures << " check(s) failed." << std::endl;
+		return 1;
+	}
+	std::cout << ">> All checks passed." << std::endl;
+
+	benchmark(rsa, options);
+	return 0;
+}
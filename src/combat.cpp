@@ -25,6 +25,8 @@
 #include "weapons.h"
 #include "configmanager.h"
 #include "events.h"
+#include "metrics.h"
+#include "tracing.h"
 
 extern Game g_game;
 extern Weapons* g_weapons;
@@ -66,39 +68,53 @@ MatrixArea createArea(const std::vector<uint32_t>& vec, uint32_t rows)
 	return area;
 }
 
-std::vector<Tile*> getList(const MatrixArea& area, const Position& targetPos)
+std::vector<Tile*> getList(const AreaStencil& stencil, const Position& targetPos)
 {
 	std::vector<Tile*> vec;
+	vec.reserve(stencil.offsets.size());
 
-	auto center = area.getCenter();
-
-	Position tmpPos(targetPos.x - center.first, targetPos.y - center.second, targetPos.z);
-	for (uint32_t row = 0; row < area.getRows(); ++row, ++tmpPos.y) {
-		for (uint32_t col = 0; col < area.getCols(); ++col, ++tmpPos.x) {
-			if (area(row, col)) {
-				if (g_game.isSightClear(targetPos, tmpPos, true)) {
-					Tile* tile = g_game.map.getTile(tmpPos);
-					if (!tile) {
-						tile = new StaticTile(tmpPos.x, tmpPos.y, tmpPos.z);
-						g_game.map.setTile(tmpPos, tile);
-					}
-					vec.push_back(tile);
-				}
+	// the offsets run row by row, so consecutive tiles mostly share a leaf of the map tree
+	const QTreeLeafNode* leaf = nullptr;
+	uint16_t leafX = 0;
+	uint16_t leafY = 0;
+
+	for (const auto& offset : stencil.offsets) {
+		Position tmpPos(targetPos.x + offset.first, targetPos.y + offset.second, targetPos.z);
+		if (!g_game.isSightClear(targetPos, tmpPos, true)) {
+			continue;
+		}
+
+		if (!leaf || (tmpPos.x & ~FLOOR_MASK) != leafX || (tmpPos.y & ~FLOOR_MASK) != leafY) {
+			leaf = g_game.map.getQTNode(tmpPos.x, tmpPos.y);
+			leafX = tmpPos.x & ~FLOOR_MASK;
+			leafY = tmpPos.y & ~FLOOR_MASK;
+		}
+
+		Tile* tile = nullptr;
+		if (leaf) {
+			if (const Floor* floor = leaf->getFloor(tmpPos.z)) {
+				tile = floor->tiles[tmpPos.x & FLOOR_MASK][tmpPos.y & FLOOR_MASK];
 			}
 		}
-		tmpPos.x -= area.getCols();
+
+		if (!tile) {
+			tile = new StaticTile(tmpPos.x, tmpPos.y, tmpPos.z);
+			g_game.map.setTile(tmpPos, tile);
+			leaf = nullptr;
+		}
+		vec.push_back(tile);
 	}
 	return vec;
 }
 
-std::vector<Tile*> getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area)
+std::vector<Tile*> getCombatArea(const Position& targetPos, const AreaStencil* stencil)
 {
 	if (targetPos.z >= MAP_MAX_LAYERS) {
 		return {};
 	}
 
-	if (area) {
-		return getList(area->getArea(centerPos, targetPos), targetPos);
+	if (stencil) {
+		return getList(*stencil, targetPos);
 	}
 
 	Tile* tile = g_game.map.getTile(targetPos);
@@ -735,29 +751,13 @@ void Combat::doCombat(Creature* caster, const Position& position) const
 		CombatDamage damage = getCombatDamage(caster, nullptr);
 		doAreaCombat(caster, position, area.get(), damage, params);
 	} else {
-		auto tiles = caster ? getCombatArea(caster->getPosition(), position, area.get()) : getCombatArea(position, position, area.get());
-
-		SpectatorVec spectators;
-		uint32_t maxX = 0;
-		uint32_t maxY = 0;
+		const AreaStencil* stencil = area ? &area->getStencil(caster ? caster->getPosition() : position, position) : nullptr;
+		auto tiles = getCombatArea(position, stencil);
 
-		//calculate the max viewable range
-		for (Tile* tile : tiles) {
-			const Position& tilePos = tile->getPosition();
-
-			uint32_t diff = Position::getDistanceX(tilePos, position);
-			if (diff > maxX) {
-				maxX = diff;
-			}
-
-			diff = Position::getDistanceY(tilePos, position);
-			if (diff > maxY) {
-				maxY = diff;
-			}
-		}
+		const int32_t rangeX = (stencil ? stencil->maxX : 0) + Map::maxViewportX;
+		const int32_t rangeY = (stencil ? stencil->maxY : 0) + Map::maxViewportY;
 
-		const int32_t rangeX = maxX + Map::maxViewportX;
-		const int32_t rangeY = maxY + Map::maxViewportY;
+		SpectatorVec spectators;
 		g_game.map.getSpectators(spectators, position, true, true, rangeX, rangeX, rangeY, rangeY);
 
 		postCombatEffects(caster, position, params);
@@ -817,6 +817,8 @@ void Combat::doCombat(Creature* caster, const Position& position) const
 
 void Combat::doTargetCombat(Creature* caster, Creature* target, CombatDamage& damage, const CombatParams& params)
 {
+	MetricTimer timer(g_metrics.targetCombat);
+
 	if (caster && target && params.distanceEffect != CONST_ANI_NONE) {
 		addDistanceEffect(caster, caster->getPosition(), target->getPosition(), params.distanceEffect);
 	}
@@ -923,7 +925,11 @@ void Combat::doTargetCombat(Creature* caster, Creature* target, CombatDamage& da
 
 void Combat::doAreaCombat(Creature* caster, const Position& position, const AreaCombat* area, CombatDamage& damage, const CombatParams& params)
 {
-	auto tiles = caster ? getCombatArea(caster->getPosition(), position, area) : getCombatArea(position, position, area);
+	MetricTimer timer(g_metrics.areaCombat);
+	TraceSpan span("doAreaCombat");
+
+	const AreaStencil* stencil = area ? &area->getStencil(caster ? caster->getPosition() : position, position) : nullptr;
+	auto tiles = getCombatArea(position, stencil);
 
 	Player* casterPlayer = caster ? caster->getPlayer() : nullptr;
 	int32_t criticalPrimary = 0;
@@ -938,26 +944,8 @@ void Combat::doAreaCombat(Creature* caster, const Position& position, const Area
 		}
 	}
 
-	uint32_t maxX = 0;
-	uint32_t maxY = 0;
-
-	//calculate the max viewable range
-	for (Tile* tile : tiles) {
-		const Position& tilePos = tile->getPosition();
-
-		uint32_t diff = Position::getDistanceX(tilePos, position);
-		if (diff > maxX) {
-			maxX = diff;
-		}
-
-		diff = Position::getDistanceY(tilePos, position);
-		if (diff > maxY) {
-			maxY = diff;
-		}
-	}
-
-	const int32_t rangeX = maxX + Map::maxViewportX;
-	const int32_t rangeY = maxY + Map::maxViewportY;
+	const int32_t rangeX = (stencil ? stencil->maxX : 0) + Map::maxViewportX;
+	const int32_t rangeY = (stencil ? stencil->maxY : 0) + Map::maxViewportY;
 
 	SpectatorVec spectators;
 	g_game.map.getSpectators(spectators, position, true, true, rangeX, rangeX, rangeY, rangeY);
@@ -1002,7 +990,20 @@ void Combat::doAreaCombat(Creature* caster, const Position& position, const Area
 	leechCombat.origin = ORIGIN_NONE;
 	leechCombat.leeched = true;
 
+	const int32_t areaX = stencil ? stencil->maxX : 0;
+	const int32_t areaY = stencil ? stencil->maxY : 0;
+
+	// hits are applied and announced target by target: scripts run by a hit must see the
+	// earlier targets already damaged, and the packets of all hits still leave each viewer
+	// in one write since they are appended to its output buffer within this task
 	for (Creature* creature : toDamageCreatures) {
+		// targets still inside the area reuse the area spectators instead of querying the map again
+		const Position& targetPos = creature->getPosition();
+		const SpectatorVec* areaSpectators = nullptr;
+		if (targetPos.z == position.z && Position::getDistanceX(targetPos, position) <= areaX && Position::getDistanceY(targetPos, position) <= areaY) {
+			areaSpectators = &spectators;
+		}
+
 		CombatDamage damageCopy = damage; // we cannot avoid copying here, because we don't know if it's player combat or not, so we can't modify the initial damage.
 		bool playerCombatReduced = false;
 		if ((damageCopy.primary.value < 0 || damageCopy.secondary.value < 0) && caster) {
@@ -1019,7 +1020,7 @@ void Combat::doAreaCombat(Creature* caster, const Position& position, const Area
 		if (damageCopy.critical) {
 			damageCopy.primary.value += playerCombatReduced ? criticalPrimary / 2 : criticalPrimary;
 			damageCopy.secondary.value += playerCombatReduced ? criticalSecondary / 2 : criticalSecondary;
-			g_game.addMagicEffect(creature->getPosition(), CONST_ME_CRITICAL_DAMAGE);
+			g_game.addMagicEffect(targetPos, CONST_ME_CRITICAL_DAMAGE);
 		}
 
 		bool success = false;
@@ -1027,9 +1028,9 @@ void Combat::doAreaCombat(Creature* caster, const Position& position, const Area
 			if (g_game.combatBlockHit(damageCopy, caster, creature, params.blockedByShield, params.blockedByArmor, params.itemId != 0)) {
 				continue;
 			}
-			success = g_game.combatChangeHealth(caster, creature, damageCopy);
+			success = g_game.combatChangeHealth(caster, creature, damageCopy, areaSpectators);
 		} else {
-			success = g_game.combatChangeMana(caster, creature, damageCopy);
+			success = g_game.combatChangeMana(caster, creature, damageCopy, areaSpectators);
 		}
 
 		if (success) {
@@ -1296,7 +1297,7 @@ MatrixArea MatrixArea::rotate270() const {
 	return {{center.second, cols - center.first - 1}, cols, rows, std::move(newArr)};
 }
 
-const MatrixArea& AreaCombat::getArea(const Position& centerPos, const Position& targetPos) const {
+Direction AreaCombat::getDirection(const Position& centerPos, const Position& targetPos) const {
 	int32_t dx = Position::getOffsetX(targetPos, centerPos);
 	int32_t dy = Position::getOffsetY(targetPos, centerPos);
 
@@ -1322,7 +1323,11 @@ const MatrixArea& AreaCombat::getArea(const Position& centerPos, const Position&
 			dir = DIRECTION_SOUTHEAST;
 		}
 	}
+	return dir;
+}
 
+const MatrixArea& AreaCombat::getArea(const Position& centerPos, const Position& targetPos) const {
+	Direction dir = getDirection(centerPos, targetPos);
 	if (dir >= areas.size()) {
 		// this should not happen. it means we forgot to call setupArea.
 		static MatrixArea empty;
@@ -1331,6 +1336,40 @@ const MatrixArea& AreaCombat::getArea(const Position& centerPos, const Position&
 	return areas[dir];
 }
 
+const AreaStencil& AreaCombat::getStencil(const Position& centerPos, const Position& targetPos) const {
+	Direction dir = getDirection(centerPos, targetPos);
+	if (dir >= stencils.size()) {
+		static AreaStencil empty;
+		return empty;
+	}
+	return stencils[dir];
+}
+
+void AreaCombat::compileStencils()
+{
+	stencils.clear();
+	stencils.resize(areas.size());
+	for (size_t i = 0; i < areas.size(); ++i) {
+		const MatrixArea& area = areas[i];
+		AreaStencil& stencil = stencils[i];
+
+		const auto& center = area.getCenter();
+		for (uint32_t row = 0; row < area.getRows(); ++row) {
+			for (uint32_t col = 0; col < area.getCols(); ++col) {
+				if (!area(row, col)) {
+					continue;
+				}
+
+				int32_t offsetX = static_cast<int32_t>(col) - static_cast<int32_t>(center.first);
+				int32_t offsetY = static_cast<int32_t>(row) - static_cast<int32_t>(center.second);
+				stencil.offsets.emplace_back(offsetX, offsetY);
+				stencil.maxX = std::max<int32_t>(stencil.maxX, std::abs(offsetX));
+				stencil.maxY = std::max<int32_t>(stencil.maxY, std::abs(offsetY));
+			}
+		}
+	}
+}
+
 void AreaCombat::setupArea(const std::vector<uint32_t>& vec, uint32_t rows)
 {
 	auto area = createArea(vec, rows);
@@ -1339,6 +1378,7 @@ void AreaCombat::setupArea(const std::vector<uint32_t>& vec, uint32_t rows)
 	areas[DIRECTION_SOUTH] = area.rotate180();
 	areas[DIRECTION_WEST] = area.rotate270();
 	areas[DIRECTION_NORTH] = std::move(area);
+	compileStencils();
 }
 
 void AreaCombat::setupArea(int32_t length, int32_t spread)
@@ -1424,6 +1464,7 @@ void AreaCombat::setupExtArea(const std::vector<uint32_t>& vec, uint32_t rows)
 	areas[DIRECTION_SOUTHWEST] = area.flip();
 	areas[DIRECTION_SOUTHEAST] = area.transpose();
 	areas[DIRECTION_NORTHWEST] = std::move(area);
+	compileStencils();
 }
 
 //**********************************************************//
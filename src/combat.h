@@ -120,6 +120,15 @@ class MatrixArea
 		uint32_t rows = 0, cols = 0;
 };
 
+struct AreaStencil
+{
+	// offsets of the affected tiles from the target position, row by row
+	std::vector<std::pair<int32_t, int32_t>> offsets;
+	// farthest offsets on each axis, the area is only seen within these plus the viewport
+	int32_t maxX = 0;
+	int32_t maxY = 0;
+};
+
 class AreaCombat
 {
 	public:
@@ -128,9 +137,14 @@ class AreaCombat
 		void setupArea(int32_t radius);
 		void setupExtArea(const std::vector<uint32_t>& vec, uint32_t rows);
 		const MatrixArea& getArea(const Position& centerPos, const Position& targetPos) const;
+		const AreaStencil& getStencil(const Position& centerPos, const Position& targetPos) const;
 
 	private:
+		Direction getDirection(const Position& centerPos, const Position& targetPos) const;
+		void compileStencils();
+
 		std::vector<MatrixArea> areas;
+		std::vector<AreaStencil> stencils;
 		bool hasExtArea = false;
 };
 /*
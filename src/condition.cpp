@@ -132,7 +132,7 @@ void Condition::serialize(PropWriteStream& propWriteStream)
 	propWriteStream.write<uint32_t>(id);
 
 	propWriteStream.write<uint8_t>(CONDITIONATTR_TICKS);
-	propWriteStream.write<uint32_t>(ticks);
+	propWriteStream.write<uint32_t>(getTicks());
 
 	propWriteStream.write<uint8_t>(CONDITIONATTR_ISBUFF);
 	propWriteStream.write<uint8_t>(isBuff);
@@ -144,20 +144,27 @@ void Condition::serialize(PropWriteStream& propWriteStream)
 	propWriteStream.write<uint8_t>(aggressive);
 }
 
+int32_t Condition::getTicks() const
+{
+	if (!started || ticks <= 0) {
+		return ticks;
+	}
+
+	// once started the remaining ticks follow from the end time
+	return static_cast<int32_t>(std::max<int64_t>(0, endTime - OTSYS_TIME()));
+}
+
 void Condition::setTicks(int32_t newTicks)
 {
 	ticks = newTicks;
 	endTime = ticks + OTSYS_TIME();
 }
 
-bool Condition::executeCondition(Creature*, int32_t interval)
+bool Condition::executeCondition(Creature*, int32_t)
 {
 	if (ticks == -1) {
 		return true;
 	}
-
-	//Not using set ticks here since it would reset endTime
-	ticks = std::max<int32_t>(0, ticks - interval);
 	return getEndTime() >= OTSYS_TIME();
 }
 
@@ -284,6 +291,7 @@ bool Condition::startCondition(Creature*)
 	if (ticks > 0) {
 		endTime = ticks + OTSYS_TIME();
 	}
+	started = true;
 	return true;
 }
 
@@ -1021,6 +1029,13 @@ bool ConditionRegeneration::executeCondition(Creature* creature, int32_t interva
 	return ConditionGeneric::executeCondition(creature, interval);
 }
 
+int32_t ConditionRegeneration::getTickDelay() const
+{
+	int64_t healthDelay = static_cast<int64_t>(healthTicks) - internalHealthTicks;
+	int64_t manaDelay = static_cast<int64_t>(manaTicks) - internalManaTicks;
+	return static_cast<int32_t>(std::max<int64_t>(0, std::min(healthDelay, manaDelay)));
+}
+
 bool ConditionRegeneration::setParam(ConditionParam_t param, int32_t value)
 {
 	bool ret = ConditionGeneric::setParam(param, value);
@@ -1096,6 +1111,11 @@ bool ConditionSoul::executeCondition(Creature* creature, int32_t interval)
 	return ConditionGeneric::executeCondition(creature, interval);
 }
 
+int32_t ConditionSoul::getTickDelay() const
+{
+	return static_cast<int32_t>(std::max<int64_t>(0, static_cast<int64_t>(soulTicks) - internalSoulTicks));
+}
+
 bool ConditionSoul::setParam(ConditionParam_t param, int32_t value)
 {
 	bool ret = ConditionGeneric::setParam(param, value);
@@ -1340,6 +1360,17 @@ bool ConditionDamage::executeCondition(Creature* creature, int32_t interval)
 	return Condition::executeCondition(creature, interval);
 }
 
+int32_t ConditionDamage::getTickDelay() const
+{
+	if (periodDamage != 0) {
+		return std::max<int32_t>(0, tickInterval - periodDamageTick);
+	} else if (!damageList.empty()) {
+		// the damage rounds stay on the same ticks, only the idle ones in between are skipped
+		return std::max<int32_t>(0, damageList.front().timeLeft);
+	}
+	return Condition::getTickDelay();
+}
+
 bool ConditionDamage::getNextDamage(int32_t& damage)
 {
 	if (periodDamage != 0) {
@@ -1754,6 +1785,14 @@ bool ConditionLight::executeCondition(Creature* creature, int32_t interval)
 	return Condition::executeCondition(creature, interval);
 }
 
+int32_t ConditionLight::getTickDelay() const
+{
+	if (lightInfo.level == 0) {
+		return Condition::getTickDelay();
+	}
+	return static_cast<int32_t>(std::max<int64_t>(0, static_cast<int64_t>(lightChangeInterval) - internalLightTicks));
+}
+
 void ConditionLight::endCondition(Creature* creature)
 {
 	creature->setNormalCreatureLight();
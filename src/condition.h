@@ -22,6 +22,7 @@
 
 #include "fileloader.h"
 #include "enums.h"
+#include "objectpool.h"
 
 class Creature;
 class Player;
@@ -75,11 +76,26 @@ class Condition
 		Condition(ConditionId_t id, ConditionType_t type, int32_t ticks, bool buff = false, uint32_t subId = 0, bool aggressive = false) :
 			endTime(ticks == -1 ? std::numeric_limits<int64_t>::max() : 0),
 			subId(subId), ticks(ticks), conditionType(type), isBuff(buff), aggressive(aggressive), id(id) {}
+		// a copy of a running condition is not started, it starts over with the ticks the original had left
+		Condition(const Condition& other) :
+			endTime(other.endTime), lastExecution(other.lastExecution), subId(other.subId), ticks(other.getTicks()),
+			conditionType(other.conditionType), isBuff(other.isBuff), aggressive(other.aggressive), id(other.id) {}
 		virtual ~Condition() = default;
 
+		static void* operator new(size_t size) {
+			return getConditionAllocator().allocate(size);
+		}
+		static void operator delete(void* p, size_t size) {
+			getConditionAllocator().deallocate(p, size);
+		}
+
 		virtual bool startCondition(Creature* creature);
 		virtual bool executeCondition(Creature* creature, int32_t interval);
 		virtual void endCondition(Creature* creature) = 0;
+		// think time that may pass before executeCondition has anything to do besides ending the condition
+		virtual int32_t getTickDelay() const {
+			return std::numeric_limits<int32_t>::max();
+		}
 		virtual void addCondition(Creature* creature, const Condition* condition) = 0;
 		virtual uint32_t getIcons() const;
 		ConditionId_t getId() const {
@@ -97,10 +113,14 @@ class Condition
 		int64_t getEndTime() const {
 			return endTime;
 		}
-		int32_t getTicks() const {
-			return ticks;
-		}
+		int32_t getTicks() const;
 		void setTicks(int32_t newTicks);
+		int64_t getLastExecution() const {
+			return lastExecution;
+		}
+		void setLastExecution(int64_t thinkTime) {
+			lastExecution = thinkTime;
+		}
 		bool isAggressive() const {
 			return aggressive;
 		}
@@ -121,11 +141,13 @@ class Condition
 		virtual bool updateCondition(const Condition* addCondition);
 
 		int64_t endTime;
+		int64_t lastExecution = 0;
 		uint32_t subId;
 		int32_t ticks;
 		ConditionType_t conditionType;
 		bool isBuff;
 		bool aggressive;
+		bool started = false;
 
 	private:
 		ConditionId_t id;
@@ -194,6 +216,7 @@ class ConditionRegeneration final : public ConditionGeneric
 
 		void addCondition(Creature* creature, const Condition* condition) override;
 		bool executeCondition(Creature* creature, int32_t interval) override;
+		int32_t getTickDelay() const override;
 
 		bool setParam(ConditionParam_t param, int32_t value) override;
 
@@ -223,6 +246,7 @@ class ConditionSoul final : public ConditionGeneric
 
 		void addCondition(Creature* creature, const Condition* condition) override;
 		bool executeCondition(Creature* creature, int32_t interval) override;
+		int32_t getTickDelay() const override;
 
 		bool setParam(ConditionParam_t param, int32_t value) override;
 
@@ -267,6 +291,7 @@ class ConditionDamage final : public Condition
 		bool executeCondition(Creature* creature, int32_t interval) override;
 		void endCondition(Creature* creature) override;
 		void addCondition(Creature* creature, const Condition* condition) override;
+		int32_t getTickDelay() const override;
 		uint32_t getIcons() const override;
 
 		ConditionDamage* clone() const override {
@@ -382,6 +407,7 @@ class ConditionLight final : public Condition
 		bool executeCondition(Creature* creature, int32_t interval) override;
 		void endCondition(Creature* creature) override;
 		void addCondition(Creature* creature, const Condition* condition) override;
+		int32_t getTickDelay() const override;
 
 		ConditionLight* clone() const override {
 			return new ConditionLight(*this);
@@ -207,6 +207,7 @@ bool ConfigManager::load()
 		}
 
 		integer[STATUS_PORT] = getGlobalNumber(L, "statusProtocolPort", 7171);
+		integer[METRICS_PORT] = getGlobalNumber(L, "metricsProtocolPort", 0);
 
 		integer[MARKET_OFFER_DURATION] = getGlobalNumber(L, "marketOfferDuration", 30 * 24 * 60 * 60);
 	}
@@ -246,6 +247,7 @@ bool ConfigManager::load()
 	boolean[HOUSE_DOOR_SHOW_PRICE] = getGlobalBoolean(L, "houseDoorShowPrice", true);
 	boolean[ONLY_INVITED_CAN_MOVE_HOUSE_ITEMS] = getGlobalBoolean(L, "onlyInvitedCanMoveHouseItems", true);
 	boolean[REMOVE_ON_DESPAWN] = getGlobalBoolean(L, "removeOnDespawn", true);
+	boolean[PLAYER_UPDATE_DELTAS] = getGlobalBoolean(L, "playerUpdateDeltas", false);
 
 	string[DEFAULT_PRIORITY] = getGlobalString(L, "defaultPriority", "high");
 	string[SERVER_NAME] = getGlobalString(L, "serverName", "");
@@ -286,6 +288,13 @@ bool ConfigManager::load()
 	integer[YELL_MINIMUM_LEVEL] = getGlobalNumber(L, "yellMinimumLevel", 2);
 	integer[VIP_FREE_LIMIT] = getGlobalNumber(L, "vipFreeLimit", 20);
 	integer[VIP_PREMIUM_LIMIT] = getGlobalNumber(L, "vipPremiumLimit", 100);
+	integer[COMPRESSION_LEVEL] = getGlobalNumber(L, "compressionLevel", 0);
+	integer[COMPRESSION_THRESHOLD] = getGlobalNumber(L, "compressionThreshold", 128);
+	integer[COMPRESSION_OPCODE] = getGlobalNumber(L, "compressionOpcode", 0xFF);
+	integer[PLAYER_UPDATE_OPCODE] = getGlobalNumber(L, "playerUpdateOpcode", 0xFE);
+	integer[CRYPTO_THREADS] = getGlobalNumber(L, "cryptoThreads", 2);
+	integer[WORKER_THREADS] = getGlobalNumber(L, "workerThreads", 2);
+	integer[LAG_WATCHDOG_THRESHOLD] = getGlobalNumber(L, "lagWatchdogThreshold", 0);
 
 	expStages = loadXMLStages();
 	if (expStages.empty()) {
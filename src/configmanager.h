@@ -68,6 +68,7 @@ class ConfigManager
 			HOUSE_DOOR_SHOW_PRICE,
 			ONLY_INVITED_CAN_MOVE_HOUSE_ITEMS,
 			REMOVE_ON_DESPAWN,
+			PLAYER_UPDATE_DELTAS,
 
 			LAST_BOOLEAN_CONFIG /* this must be the last one */
 		};
@@ -121,6 +122,7 @@ class ConfigManager
 			GAME_PORT,
 			LOGIN_PORT,
 			STATUS_PORT,
+			METRICS_PORT,
 			STAIRHOP_DELAY,
 			MARKET_OFFER_DURATION,
 			CHECK_EXPIRED_MARKET_OFFERS_EACH_MINUTES,
@@ -131,6 +133,13 @@ class ConfigManager
 			YELL_MINIMUM_LEVEL,
 			VIP_FREE_LIMIT,
 			VIP_PREMIUM_LIMIT,
+			COMPRESSION_LEVEL,
+			COMPRESSION_THRESHOLD,
+			COMPRESSION_OPCODE,
+			PLAYER_UPDATE_OPCODE,
+			CRYPTO_THREADS,
+			WORKER_THREADS,
+			LAG_WATCHDOG_THRESHOLD,
 
 			LAST_INTEGER_CONFIG /* this must be the last one */
 		};
@@ -21,6 +21,8 @@
 
 #include "configmanager.h"
 #include "connection.h"
+#include "cryptotasks.h"
+#include "metrics.h"
 #include "outputmessage.h"
 #include "protocol.h"
 #include "scheduler.h"
@@ -216,8 +218,24 @@ void Connection::parsePacket(const boost::system::error_code& error)
 			msg.skipBytes(1); // Skip protocol ID
 		}
 
+		if (protocol->traffic) {
+			protocol->traffic->bytesReceived.add(msg.getLength());
+		}
+
+		if (protocol->hasEncryptedFirstMessage()) {
+			// reading resumes once a crypto worker has handled the message, the copy
+			// is needed because msg is the receive buffer of this connection
+			auto task = std::bind(&Connection::parseEncryptedFirstMessage, shared_from_this(), msg);
+			if (g_cryptoTasks.addTask(std::move(task))) {
+				return;
+			}
+		}
+
 		protocol->onRecvFirstMessage(msg);
 	} else {
+		if (protocol->traffic) {
+			protocol->traffic->bytesReceived.add(msg.getLength());
+		}
 		protocol->onRecvMessage(msg); // Send the packet to the current protocol
 	}
 
@@ -236,6 +254,22 @@ void Connection::parsePacket(const boost::system::error_code& error)
 	}
 }
 
+void Connection::parseEncryptedFirstMessage(NetworkMessage& msg)
+{
+	std::lock_guard<std::recursive_mutex> lockClass(connectionLock);
+	if (closed) {
+		return;
+	}
+
+	protocol->onRecvFirstMessage(msg);
+	if (closed) {
+		return;
+	}
+
+	// Wait to the next packet
+	accept();
+}
+
 void Connection::send(const OutputMessage_ptr& msg)
 {
 	std::lock_guard<std::recursive_mutex> lockClass(connectionLock);
@@ -253,6 +287,9 @@ void Connection::send(const OutputMessage_ptr& msg)
 void Connection::internalSend(const OutputMessage_ptr& msg)
 {
 	protocol->onSendMessage(msg);
+	if (protocol->traffic) {
+		protocol->traffic->bytesSent.add(msg->getLength());
+	}
 	try {
 		writeTimer.expires_from_now(std::chrono::seconds(CONNECTION_WRITE_TIMEOUT));
 		writeTimer.async_wait(std::bind(&Connection::handleTimeout, std::weak_ptr<Connection>(shared_from_this()),
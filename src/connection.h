@@ -91,6 +91,7 @@ class Connection : public std::enable_shared_from_this<Connection>
 	private:
 		void parseHeader(const boost::system::error_code& error);
 		void parsePacket(const boost::system::error_code& error);
+		void parseEncryptedFirstMessage(NetworkMessage& msg);
 
 		void onWriteOperation(const boost::system::error_code& error);
 
@@ -99,6 +99,7 @@ void Container::addItem(Item* item)
 {
 	itemlist.push_back(item);
 	item->setParent(this);
+	updateItemTypeCounts(item, true);
 }
 
 Attr_ReadValue Container::readAttr(AttrTypes_t attr, PropStream& propStream)
@@ -154,6 +155,13 @@ void Container::updateItemWeight(int32_t diff)
 	}
 }
 
+void Container::updateItemTypeCounts(const Item* item, bool add)
+{
+	if (Player* player = getCarryingPlayer()) {
+		player->updateItemTypeCounts(item, add);
+	}
+}
+
 uint32_t Container::getWeight() const
 {
 	return Item::getWeight() + totalWeight;
@@ -514,6 +522,7 @@ void Container::addThing(int32_t index, Thing* thing)
 	item->setParent(this);
 	itemlist.push_front(item);
 	updateItemWeight(item->getWeight());
+	updateItemTypeCounts(item, true);
 
 	//send change to client
 	if (getParent() && (getParent() != VirtualCylinder::virtualCylinder)) {
@@ -570,6 +579,8 @@ void Container::replaceThing(uint32_t index, Thing* thing)
 	itemlist[index] = item;
 	item->setParent(this);
 	updateItemWeight(-static_cast<int32_t>(replacedItem->getWeight()) + item->getWeight());
+	updateItemTypeCounts(replacedItem, false);
+	updateItemTypeCounts(item, true);
 
 	//send change to client
 	if (getParent()) {
@@ -603,6 +614,7 @@ void Container::removeThing(Thing* thing, uint32_t count)
 		}
 	} else {
 		updateItemWeight(-static_cast<int32_t>(item->getWeight()));
+		updateItemTypeCounts(item, false);
 
 		//send change to client
 		if (getParent()) {
@@ -720,6 +732,7 @@ void Container::internalAddThing(uint32_t, Thing* thing)
 	item->setParent(this);
 	itemlist.push_front(item);
 	updateItemWeight(item->getWeight());
+	updateItemTypeCounts(item, true);
 }
 
 void Container::startDecaying()
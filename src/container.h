@@ -180,6 +180,7 @@ class Container : public Item, public Cylinder
 
 		Container* getParentContainer();
 		void updateItemWeight(int32_t diff);
+		void updateItemTypeCounts(const Item* item, bool add);
 
 		friend class ContainerIterator;
 		friend class IOMapSerialize;
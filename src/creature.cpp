@@ -323,24 +323,42 @@ void Creature::stopEventWalk()
 
 void Creature::updateMapCache()
 {
-	Tile* tile;
 	const Position& myPos = getPosition();
-	Position pos(0, 0, myPos.z);
-
 	for (int32_t y = -maxWalkCacheHeight; y <= maxWalkCacheHeight; ++y) {
-		for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
-			pos.x = myPos.getX() + x;
-			pos.y = myPos.getY() + y;
-			tile = g_game.map.getTile(pos);
-			updateTileCache(tile, pos);
+		localMapCache[maxWalkCacheHeight + y] = getWalkableCells(myPos.x - maxWalkCacheWidth, myPos.y + y, mapWalkWidth);
+	}
+}
+
+uint32_t Creature::getWalkableCells(int32_t x, int32_t y, int32_t width) const
+{
+	const Position& myPos = getPosition();
+	if (const Monster* monster = getMonster()) {
+		return g_game.map.getWalkableRow(*this, monster->canPushItems(), x, y, myPos.z, width);
+	}
+
+	uint32_t cells = 0;
+	if (y < 0) {
+		return cells;
+	}
+
+	for (int32_t i = std::max<int32_t>(0, -x); i < width; ++i) {
+		const Tile* tile = g_game.map.getTile(x + i, y, myPos.z);
+		if (tile && tile->queryAdd(0, *this, 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) == RETURNVALUE_NOERROR) {
+			cells |= static_cast<uint32_t>(1) << i;
 		}
 	}
+	return cells;
 }
 
 void Creature::updateTileCache(const Tile* tile, int32_t dx, int32_t dy)
 {
 	if (std::abs(dx) <= maxWalkCacheWidth && std::abs(dy) <= maxWalkCacheHeight) {
-		localMapCache[maxWalkCacheHeight + dy][maxWalkCacheWidth + dx] = tile && tile->queryAdd(0, *this, 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) == RETURNVALUE_NOERROR;
+		const uint32_t bit = static_cast<uint32_t>(1) << (maxWalkCacheWidth + dx);
+		if (tile && tile->queryAdd(0, *this, 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) == RETURNVALUE_NOERROR) {
+			localMapCache[maxWalkCacheHeight + dy] |= bit;
+		} else {
+			localMapCache[maxWalkCacheHeight + dy] &= ~bit;
+		}
 	}
 }
 
@@ -373,7 +391,7 @@ int32_t Creature::getWalkCache(const Position& pos) const
 	if (std::abs(dx) <= maxWalkCacheWidth) {
 		int32_t dy = Position::getOffsetY(pos, myPos);
 		if (std::abs(dy) <= maxWalkCacheHeight) {
-			if (localMapCache[maxWalkCacheHeight + dy][maxWalkCacheWidth + dx]) {
+			if (localMapCache[maxWalkCacheHeight + dy] & (static_cast<uint32_t>(1) << (maxWalkCacheWidth + dx))) {
 				return 1;
 			} else {
 				return 0;
@@ -523,76 +541,35 @@ void Creature::onCreatureMove(Creature* creature, const Tile* newTile, const Pos
 			} else {
 				const Position& myPos = getPosition();
 
+				// the row that came into view is read whole, it must not be shifted sideways afterwards
+				int32_t freshRow = -1;
 				if (oldPos.y > newPos.y) { //north
-					//shift y south
-					for (int32_t y = mapWalkHeight - 1; --y >= 0;) {
-						memcpy(localMapCache[y + 1], localMapCache[y], sizeof(localMapCache[y]));
-					}
-
-					//update 0
-					for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
-						Tile* cacheTile = g_game.map.getTile(myPos.getX() + x, myPos.getY() - maxWalkCacheHeight, myPos.z);
-						updateTileCache(cacheTile, x, -maxWalkCacheHeight);
-					}
+					//shift rows south
+					memmove(&localMapCache[1], &localMapCache[0], sizeof(localMapCache[0]) * (mapWalkHeight - 1));
+					localMapCache[0] = getWalkableCells(myPos.x - maxWalkCacheWidth, myPos.y - maxWalkCacheHeight, mapWalkWidth);
+					freshRow = 0;
 				} else if (oldPos.y < newPos.y) { // south
-					//shift y north
-					for (int32_t y = 0; y <= mapWalkHeight - 2; ++y) {
-						memcpy(localMapCache[y], localMapCache[y + 1], sizeof(localMapCache[y]));
-					}
-
-					//update mapWalkHeight - 1
-					for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
-						Tile* cacheTile = g_game.map.getTile(myPos.getX() + x, myPos.getY() + maxWalkCacheHeight, myPos.z);
-						updateTileCache(cacheTile, x, maxWalkCacheHeight);
-					}
+					//shift rows north
+					memmove(&localMapCache[0], &localMapCache[1], sizeof(localMapCache[0]) * (mapWalkHeight - 1));
+					localMapCache[mapWalkHeight - 1] = getWalkableCells(myPos.x - maxWalkCacheWidth, myPos.y + maxWalkCacheHeight, mapWalkWidth);
+					freshRow = mapWalkHeight - 1;
 				}
 
-				if (oldPos.x < newPos.x) { // east
-					//shift y west
-					int32_t starty = 0;
-					int32_t endy = mapWalkHeight - 1;
-					int32_t dy = Position::getDistanceY(oldPos, newPos);
-
-					if (dy < 0) {
-						endy += dy;
-					} else if (dy > 0) {
-						starty = dy;
-					}
-
-					for (int32_t y = starty; y <= endy; ++y) {
-						for (int32_t x = 0; x <= mapWalkWidth - 2; ++x) {
-							localMapCache[y][x] = localMapCache[y][x + 1];
+				if (oldPos.x != newPos.x) {
+					const bool east = oldPos.x < newPos.x;
+					const int32_t edge = east ? maxWalkCacheWidth : -maxWalkCacheWidth;
+					const uint32_t edgeBit = static_cast<uint32_t>(1) << (maxWalkCacheWidth + edge);
+					for (int32_t y = 0; y < mapWalkHeight; ++y) {
+						if (y == freshRow) {
+							continue;
 						}
-					}
-
-					//update mapWalkWidth - 1
-					for (int32_t y = -maxWalkCacheHeight; y <= maxWalkCacheHeight; ++y) {
-						Tile* cacheTile = g_game.map.getTile(myPos.x + maxWalkCacheWidth, myPos.y + y, myPos.z);
-						updateTileCache(cacheTile, maxWalkCacheWidth, y);
-					}
-				} else if (oldPos.x > newPos.x) { // west
-					//shift y east
-					int32_t starty = 0;
-					int32_t endy = mapWalkHeight - 1;
-					int32_t dy = Position::getDistanceY(oldPos, newPos);
-
-					if (dy < 0) {
-						endy += dy;
-					} else if (dy > 0) {
-						starty = dy;
-					}
 
-					for (int32_t y = starty; y <= endy; ++y) {
-						for (int32_t x = mapWalkWidth - 1; --x >= 0;) {
-							localMapCache[y][x + 1] = localMapCache[y][x];
+						uint32_t& row = localMapCache[y];
+						row = (east ? (row >> 1) : (row << 1)) & mapWalkRowMask & ~edgeBit;
+						if (getWalkableCells(myPos.x + edge, myPos.y + y - maxWalkCacheHeight, 1) != 0) {
+							row |= edgeBit;
 						}
 					}
-
-					//update 0
-					for (int32_t y = -maxWalkCacheHeight; y <= maxWalkCacheHeight; ++y) {
-						Tile* cacheTile = g_game.map.getTile(myPos.x - maxWalkCacheWidth, myPos.y + y, myPos.z);
-						updateTileCache(cacheTile, -maxWalkCacheWidth, y);
-					}
 				}
 
 				updateTileCache(oldTile, oldPos);
@@ -925,7 +902,7 @@ void Creature::goToFollowCreature()
 				if (!monster->getDistanceStep(followCreature->getPosition(), dir)) {
 					// if we can't get anything then let the A* calculate
 					listWalkDir.clear();
-					if (getPathTo(followCreature->getPosition(), listWalkDir, fpp)) {
+					if (getPathToFollowCreature(fpp)) {
 						hasFollowPath = true;
 						startAutoWalk();
 					} else {
@@ -944,7 +921,7 @@ void Creature::goToFollowCreature()
 			}
 		} else {
 			listWalkDir.clear();
-			if (getPathTo(followCreature->getPosition(), listWalkDir, fpp)) {
+			if (getPathToFollowCreature(fpp)) {
 				hasFollowPath = true;
 				startAutoWalk();
 			} else {
@@ -956,6 +933,60 @@ void Creature::goToFollowCreature()
 	onFollowCreatureComplete(followCreature);
 }
 
+bool Creature::getPathToFollowCreature(const FindPathParams& fpp)
+{
+	if (followPathPrefetch.valid) {
+		followPathPrefetch.valid = false;
+
+		// earlier creatures of the same tick may have moved, the path is only reused if its ends still match
+		if (followPathPrefetch.target == followCreature && followPathPrefetch.fpp == fpp &&
+		        followPathPrefetch.from == getPosition() && followPathPrefetch.to == followCreature->getPosition()) {
+			listWalkDir.swap(followPathPrefetch.path);
+			return followPathPrefetch.found;
+		}
+	}
+	return getPathTo(followCreature->getPosition(), listWalkDir, fpp);
+}
+
+bool Creature::needsFollowPathPrefetch(uint32_t interval) const
+{
+	// players are left out, their path search updates the walkthrough state
+	const Monster* monster = getMonster();
+	if (!monster || !followCreature) {
+		return false;
+	}
+
+	if (!isUpdatingPath && !forceUpdateFollowPath && walkUpdateTicks + interval < 2000) {
+		return false;
+	}
+
+	if (!isMapLoaded && useCacheMap()) {
+		return false;
+	}
+
+	return master == followCreature || canSeeCreature(followCreature);
+}
+
+void Creature::prefetchFollowPath()
+{
+	FindPathParams& fpp = followPathPrefetch.fpp;
+	fpp = FindPathParams();
+	getPathSearchParams(followCreature, fpp);
+
+	// fleeing and distance monsters step through getDistanceStep instead
+	const Monster* monster = getMonster();
+	if (!monster->getMaster() && (monster->isFleeing() || fpp.maxTargetDist > 1)) {
+		return;
+	}
+
+	followPathPrefetch.path.clear();
+	followPathPrefetch.from = getPosition();
+	followPathPrefetch.to = followCreature->getPosition();
+	followPathPrefetch.target = followCreature;
+	followPathPrefetch.found = getPathTo(followPathPrefetch.to, followPathPrefetch.path, fpp);
+	followPathPrefetch.valid = true;
+}
+
 bool Creature::setFollowCreature(Creature* creature)
 {
 	if (creature) {
@@ -1184,12 +1215,15 @@ bool Creature::addCondition(Condition* condition, bool force/* = false*/)
 	Condition* prevCond = getCondition(condition->getType(), condition->getId(), condition->getSubId());
 	if (prevCond) {
 		prevCond->addCondition(this, condition);
+		scheduleCondition(prevCond);
 		delete condition;
 		return true;
 	}
 
 	if (condition->startCondition(this)) {
+		condition->setLastExecution(conditionThinkTime);
 		conditions.push_back(condition);
+		scheduleCondition(condition);
 		onAddCondition(condition->getType());
 		return true;
 	}
@@ -1323,14 +1357,32 @@ Condition* Creature::getCondition(ConditionType_t type, ConditionId_t conditionI
 
 void Creature::executeConditions(uint32_t interval)
 {
-	ConditionList tempConditions{ conditions };
-	for (Condition* condition : tempConditions) {
+	conditionThinkTime += interval;
+	if (conditions.empty()) {
+		return;
+	}
+
+	int64_t timeNow = OTSYS_TIME();
+	if (conditionThinkTime < nextConditionTick && timeNow < nextConditionEnd) {
+		return;
+	}
+
+	std::vector<Condition*> dueConditions;
+	for (Condition* condition : conditions) {
+		if (conditionThinkTime - condition->getLastExecution() >= condition->getTickDelay() || (condition->getTicks() != -1 && timeNow >= condition->getEndTime())) {
+			dueConditions.push_back(condition);
+		}
+	}
+
+	for (Condition* condition : dueConditions) {
 		auto it = std::find(conditions.begin(), conditions.end(), condition);
 		if (it == conditions.end()) {
 			continue;
 		}
 
-		if (!condition->executeCondition(this, interval)) {
+		int32_t elapsed = static_cast<int32_t>(conditionThinkTime - condition->getLastExecution());
+		condition->setLastExecution(conditionThinkTime);
+		if (!condition->executeCondition(this, elapsed)) {
 			it = std::find(conditions.begin(), conditions.end(), condition);
 			if (it != conditions.end()) {
 				conditions.erase(it);
@@ -1340,6 +1392,25 @@ void Creature::executeConditions(uint32_t interval)
 			}
 		}
 	}
+
+	// timing changes made to attached conditions from scripts are picked up within EVENT_CONDITION_MAX_SLEEP
+	nextConditionTick = std::numeric_limits<int64_t>::max();
+	nextConditionEnd = timeNow + EVENT_CONDITION_MAX_SLEEP;
+	for (const Condition* condition : conditions) {
+		scheduleCondition(condition);
+	}
+}
+
+void Creature::scheduleCondition(const Condition* condition)
+{
+	int32_t tickDelay = condition->getTickDelay();
+	if (tickDelay != std::numeric_limits<int32_t>::max()) {
+		nextConditionTick = std::min<int64_t>(nextConditionTick, condition->getLastExecution() + tickDelay);
+	}
+
+	if (condition->getTicks() != -1) {
+		nextConditionEnd = std::min<int64_t>(nextConditionEnd, condition->getEndTime());
+	}
 }
 
 bool Creature::hasCondition(ConditionType_t type, uint32_t subId/* = 0*/) const
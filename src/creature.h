@@ -57,6 +57,13 @@ struct FindPathParams {
 	int32_t maxSearchDist = 0;
 	int32_t minTargetDist = -1;
 	int32_t maxTargetDist = -1;
+
+	bool operator==(const FindPathParams& other) const {
+		return fullPathSearch == other.fullPathSearch && clearSight == other.clearSight &&
+		       allowDiagonal == other.allowDiagonal && keepDistance == other.keepDistance &&
+		       maxSearchDist == other.maxSearchDist && minTargetDist == other.minTargetDist &&
+		       maxTargetDist == other.maxTargetDist;
+	}
 };
 
 class Map;
@@ -74,6 +81,7 @@ interval and count
 static constexpr int32_t EVENT_CREATURECOUNT = 10;
 static constexpr int32_t EVENT_CREATURE_THINK_INTERVAL = 100;
 static constexpr int32_t EVENT_CHECK_CREATURE_INTERVAL = (EVENT_CREATURE_THINK_INTERVAL / EVENT_CREATURECOUNT);
+static constexpr int32_t EVENT_CONDITION_MAX_SLEEP = 1000;
 
 class FrozenPathingConditionCall
 {
@@ -253,6 +261,11 @@ class Creature : virtual public Thing
 		void stopEventWalk();
 		virtual void goToFollowCreature();
 
+		// Follow path that onThink is about to search for, computed ahead by
+		// Game::checkCreatures on the worker pool while the world is frozen
+		bool needsFollowPathPrefetch(uint32_t interval) const;
+		void prefetchFollowPath();
+
 		//walk events
 		virtual void onWalk(Direction& dir);
 		virtual void onWalkAborted() {}
@@ -371,6 +384,7 @@ class Creature : virtual public Thing
 		Condition* getCondition(ConditionType_t type) const;
 		Condition* getCondition(ConditionType_t type, ConditionId_t conditionId, uint32_t subId = 0) const;
 		void executeConditions(uint32_t interval);
+		void scheduleCondition(const Condition* condition);
 		bool hasCondition(ConditionType_t type, uint32_t subId = 0) const;
 		virtual bool isImmune(ConditionType_t type) const;
 		virtual bool isImmune(CombatType_t type) const;
@@ -533,6 +547,7 @@ class Creature : virtual public Thing
 		static constexpr int32_t mapWalkHeight = Map::maxViewportY * 2 + 1;
 		static constexpr int32_t maxWalkCacheWidth = (mapWalkWidth - 1) / 2;
 		static constexpr int32_t maxWalkCacheHeight = (mapWalkHeight - 1) / 2;
+		static constexpr uint32_t mapWalkRowMask = (static_cast<uint32_t>(1) << mapWalkWidth) - 1;
 
 		Position position;
 
@@ -543,8 +558,24 @@ class Creature : virtual public Thing
 		CreatureEventList eventsList;
 		ConditionList conditions;
 
+		// think time handed to executeConditions so far, and when its next condition is due
+		int64_t conditionThinkTime = 0;
+		int64_t nextConditionTick = 0;
+		int64_t nextConditionEnd = 0;
+
 		std::vector<Direction> listWalkDir;
 
+		struct FollowPathPrefetch {
+			std::vector<Direction> path;
+			FindPathParams fpp;
+			Position from;
+			Position to;
+			const Creature* target = nullptr;
+			bool found = false;
+			bool valid = false;
+		};
+		FollowPathPrefetch followPathPrefetch;
+
 		Tile* tile = nullptr;
 		Creature* attackedCreature = nullptr;
 		Creature* master = nullptr;
@@ -574,7 +605,8 @@ class Creature : virtual public Thing
 		Direction direction = DIRECTION_SOUTH;
 		Skulls_t skull = SKULL_NONE;
 
-		bool localMapCache[mapWalkHeight][mapWalkWidth] = {{ false }};
+		// one row per y offset, bit maxWalkCacheWidth + dx set when that tile is walkable
+		uint32_t localMapCache[mapWalkHeight] = {};
 		bool isInternalRemoved = false;
 		bool isMapLoaded = false;
 		bool isUpdatingPath = false;
@@ -595,7 +627,10 @@ class Creature : virtual public Thing
 		}
 		CreatureEventList getCreatureEvents(CreatureEventType_t type);
 
+		bool getPathToFollowCreature(const FindPathParams& fpp);
+
 		void updateMapCache();
+		uint32_t getWalkableCells(int32_t x, int32_t y, int32_t width) const;
 		void updateTileCache(const Tile* tile, int32_t dx, int32_t dy);
 		void updateTileCache(const Tile* tile, const Position& pos);
 		void onCreatureDisappear(const Creature* creature, bool isLogout);
@@ -0,0 +1,100 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "cryptotasks.h"
+
+void CryptoTasks::start(size_t threadCount)
+{
+	std::lock_guard<std::mutex> lockClass(taskLock);
+	running = threadCount > 0;
+	for (size_t i = 0; i < threadCount; ++i) {
+		threads.emplace_back(&CryptoTasks::threadMain, this);
+	}
+}
+
+void CryptoTasks::threadMain()
+{
+	std::list<TaskFunc> batch;
+	std::unique_lock<std::mutex> taskLockUnique(taskLock);
+	while (true) {
+		taskSignal.wait(taskLockUnique, [this]() { return !running || !tasks.empty(); });
+		if (tasks.empty()) {
+			// only reached once shutdown() has been called and the queue is drained
+			break;
+		}
+
+		auto last = tasks.begin();
+		std::advance(last, std::min(tasks.size(), MAX_BATCH_SIZE));
+		batch.splice(batch.end(), tasks, tasks.begin(), last);
+
+		bool wakeAnother = !tasks.empty();
+		taskLockUnique.unlock();
+
+		if (wakeAnother) {
+			taskSignal.notify_one();
+		}
+
+		for (TaskFunc& task : batch) {
+			task();
+		}
+		batch.clear();
+
+		taskLockUnique.lock();
+	}
+}
+
+bool CryptoTasks::addTask(TaskFunc&& task)
+{
+	bool signal;
+	{
+		std::lock_guard<std::mutex> lockClass(taskLock);
+		if (!running) {
+			return false;
+		}
+
+		signal = tasks.empty();
+		tasks.emplace_back(std::move(task));
+	}
+
+	if (signal) {
+		taskSignal.notify_one();
+	}
+	return true;
+}
+
+void CryptoTasks::shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lockClass(taskLock);
+		running = false;
+	}
+	taskSignal.notify_all();
+}
+
+void CryptoTasks::join()
+{
+	for (std::thread& thread : threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+	threads.clear();
+}
@@ -0,0 +1,59 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_CRYPTOTASKS_H_5F0C2E6B8A7D4E3F9B1A2C3D4E5F6A7B
+#define FS_CRYPTOTASKS_H_5F0C2E6B8A7D4E3F9B1A2C3D4E5F6A7B
+
+#include <condition_variable>
+#include "tasks.h"
+
+// Worker pool for the RSA-encrypted first messages of the login and game
+// protocols, keeps the big-integer work off the network thread.
+class CryptoTasks
+{
+	public:
+		CryptoTasks() = default;
+
+		// non-copyable
+		CryptoTasks(const CryptoTasks&) = delete;
+		CryptoTasks& operator=(const CryptoTasks&) = delete;
+
+		void start(size_t threadCount);
+		void shutdown();
+		void join();
+
+		// returns false when no worker is running, the caller then has to do the work itself
+		bool addTask(TaskFunc&& task);
+
+	private:
+		void threadMain();
+
+		// tasks taken per lock acquisition during a login wave
+		static constexpr size_t MAX_BATCH_SIZE = 16;
+
+		std::vector<std::thread> threads;
+		std::list<TaskFunc> tasks;
+		std::mutex taskLock;
+		std::condition_variable taskSignal;
+		bool running = false;
+};
+
+extern CryptoTasks g_cryptoTasks;
+
+#endif
@@ -21,6 +21,7 @@
 
 #include "configmanager.h"
 #include "database.h"
+#include "metrics.h"
 
 #include <mysql/errmsg.h>
 
@@ -97,6 +98,8 @@ bool Database::executeQuery(const std::string& query)
 {
 	bool success = true;
 
+	MetricTimer timer(g_metrics.databaseQuery);
+
 	// executes the query
 	databaseLock.lock();
 
@@ -122,6 +125,8 @@ bool Database::executeQuery(const std::string& query)
 
 DBResult_ptr Database::storeQuery(const std::string& query)
 {
+	MetricTimer timer(g_metrics.databaseQuery);
+
 	databaseLock.lock();
 
 	retry:
@@ -27,18 +27,23 @@
 #include "creature.h"
 #include "creatureevent.h"
 #include "databasetasks.h"
+#include "cryptotasks.h"
+#include "workerpool.h"
 #include "events.h"
 #include "game.h"
 #include "globalevent.h"
 #include "iologindata.h"
 #include "iomarket.h"
+#include "lagwatchdog.h"
 #include "items.h"
+#include "metrics.h"
 #include "monster.h"
 #include "movement.h"
 #include "scheduler.h"
 #include "server.h"
 #include "spells.h"
 #include "talkaction.h"
+#include "tracing.h"
 #include "weapons.h"
 #include "script.h"
 
@@ -573,7 +578,11 @@ bool Game::placeCreature(Creature* creature, const Position& pos, bool extendedP
 
 	creature->getParent()->postAddNotification(creature, nullptr, 0);
 
-	addCreatureCheck(creature);
+	// monsters that found nobody around stay asleep, a target entering their view wakes them
+	Monster* monster = creature->getMonster();
+	if (!monster || !monster->getIdleStatus()) {
+		addCreatureCheck(creature);
+	}
 	creature->onPlacedCreature();
 	return true;
 }
@@ -1944,7 +1953,7 @@ void Game::playerOpenChannel(uint32_t playerId, uint16_t channelId)
 	}
 
 	const InvitedMap* invitedUsers = channel->getInvitedUsers();
-	const UsersMap* users;
+	const UsersList* users;
 	if (!channel->isPublicChannel()) {
 		users = &channel->getUsers();
 	} else {
@@ -3655,10 +3664,12 @@ bool Game::internalCreatureSay(Creature* creature, SpeakClasses type, const std:
 	}
 
 	//send to client
+	NetworkMessage msg;
+	ProtocolGame::AddCreatureSay(msg, creature, type, text, pos);
 	for (Creature* spectator : spectators) {
 		if (Player* tmpPlayer = spectator->getPlayer()) {
 			if (!ghostMode || tmpPlayer->canSeeCreature(creature)) {
-				tmpPlayer->sendCreatureSay(creature, type, text, pos);
+				tmpPlayer->sendNetworkMessage(msg);
 			}
 		}
 	}
@@ -3719,27 +3730,69 @@ void Game::removeCreatureCheck(Creature* creature)
 	}
 }
 
+size_t Game::getActiveCreatureCount() const
+{
+	size_t count = 0;
+	for (const auto& checkCreatureList : checkCreatureLists) {
+		count += std::count_if(checkCreatureList.begin(), checkCreatureList.end(), [](const Creature* creature) {
+			return creature->creatureCheck;
+		});
+	}
+	return count;
+}
+
+size_t Game::getIdleMonsterCount() const
+{
+	return std::count_if(monsters.begin(), monsters.end(), [](const std::pair<const uint32_t, Monster*>& it) {
+		return it.second->getIdleStatus();
+	});
+}
+
 void Game::checkCreatures(size_t index)
 {
 	g_scheduler.addEvent(createSchedulerTask(EVENT_CHECK_CREATURE_INTERVAL, std::bind(&Game::checkCreatures, this, (index + 1) % EVENT_CREATURECOUNT)));
 
+	MetricTimer timer(g_metrics.checkCreaturesTick);
+	TraceSpan span("checkCreatures");
+
 	auto& checkCreatureList = checkCreatureLists[index];
-	auto it = checkCreatureList.begin(), end = checkCreatureList.end();
-	while (it != end) {
-		Creature* creature = *it;
+
+	// first phase, the follow paths due this tick are searched on the worker pool,
+	// nothing modifies the world until all of them are done
+	if (g_workerPool.getThreadCount() != 0) {
+		followPathCandidates.clear();
+		for (Creature* creature : checkCreatureList) {
+			if (creature->creatureCheck && creature->getHealth() > 0 && creature->needsFollowPathPrefetch(EVENT_CREATURE_THINK_INTERVAL)) {
+				followPathCandidates.push_back(creature);
+			}
+		}
+
+		if (followPathCandidates.size() >= MIN_PARALLEL_FOLLOW_PATHS) {
+			g_workerPool.parallelFor(followPathCandidates.size(), [this](size_t i) {
+				followPathCandidates[i]->prefetchFollowPath();
+			});
+		}
+	}
+
+	// second phase, side effects in list order; creatures added meanwhile are appended and still visited
+	size_t kept = 0;
+	for (size_t i = 0; i < checkCreatureList.size(); ++i) {
+		Creature* creature = checkCreatureList[i];
 		if (creature->creatureCheck) {
 			if (creature->getHealth() > 0) {
 				creature->onThink(EVENT_CREATURE_THINK_INTERVAL);
 				creature->onAttacking(EVENT_CREATURE_THINK_INTERVAL);
 				creature->executeConditions(EVENT_CREATURE_THINK_INTERVAL);
 			}
-			++it;
+			creature->followPathPrefetch.valid = false;
+			checkCreatureList[kept++] = creature;
 		} else {
 			creature->inCheckCreaturesVector = false;
-			it = checkCreatureList.erase(it);
+			creature->followPathPrefetch.valid = false;
 			ReleaseCreature(creature);
 		}
 	}
+	checkCreatureList.resize(kept);
 
 	cleanup();
 }
@@ -4032,7 +4085,7 @@ void Game::combatGetTypeInfo(CombatType_t combatType, Creature* target, TextColo
 	}
 }
 
-bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage& damage)
+bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage& damage, const SpectatorVec* areaSpectators)
 {
 	const Position& targetPos = target->getPosition();
 	if (damage.primary.value > 0) {
@@ -4059,7 +4112,7 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 					creatureEvent->executeHealthChange(target, attacker, damage);
 				}
 				damage.origin = ORIGIN_NONE;
-				return combatChangeHealth(attacker, target, damage);
+				return combatChangeHealth(attacker, target, damage, areaSpectators);
 			}
 		}
 
@@ -4078,7 +4131,7 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 			message.primary.color = TEXTCOLOR_PASTELRED;
 
 			SpectatorVec spectators;
-			map.getSpectators(spectators, targetPos, false, true);
+			getCombatSpectators(spectators, targetPos, false, areaSpectators);
 			for (Creature* spectator : spectators) {
 				Player* tmpPlayer = spectator->getPlayer();
 				if (tmpPlayer == attackerPlayer && attackerPlayer != targetPlayer) {
@@ -4160,7 +4213,7 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 				}
 
 				targetPlayer->drainMana(attacker, manaDamage);
-				map.getSpectators(spectators, targetPos, true, true);
+				getCombatSpectators(spectators, targetPos, true, areaSpectators);
 				addMagicEffect(spectators, targetPos, CONST_ME_LOSEENERGY);
 
 				std::string spectatorMessage;
@@ -4224,7 +4277,7 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 					creatureEvent->executeHealthChange(target, attacker, damage);
 				}
 				damage.origin = ORIGIN_NONE;
-				return combatChangeHealth(attacker, target, damage);
+				return combatChangeHealth(attacker, target, damage, areaSpectators);
 			}
 		}
 
@@ -4242,7 +4295,7 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 		}
 
 		if (spectators.empty()) {
-			map.getSpectators(spectators, targetPos, true, true);
+			getCombatSpectators(spectators, targetPos, true, areaSpectators);
 		}
 
 		message.primary.value = damage.primary.value;
@@ -4320,7 +4373,7 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 	return true;
 }
 
-bool Game::combatChangeMana(Creature* attacker, Creature* target, CombatDamage& damage)
+bool Game::combatChangeMana(Creature* attacker, Creature* target, CombatDamage& damage, const SpectatorVec* areaSpectators)
 {
 	Player* targetPlayer = target->getPlayer();
 	if (!targetPlayer) {
@@ -4343,7 +4396,7 @@ bool Game::combatChangeMana(Creature* attacker, Creature* target, CombatDamage&
 					creatureEvent->executeManaChange(target, attacker, damage);
 				}
 				damage.origin = ORIGIN_NONE;
-				return combatChangeMana(attacker, target, damage);
+				return combatChangeMana(attacker, target, damage, areaSpectators);
 			}
 		}
 
@@ -4396,7 +4449,7 @@ bool Game::combatChangeMana(Creature* attacker, Creature* target, CombatDamage&
 					creatureEvent->executeManaChange(target, attacker, damage);
 				}
 				damage.origin = ORIGIN_NONE;
-				return combatChangeMana(attacker, target, damage);
+				return combatChangeMana(attacker, target, damage, areaSpectators);
 			}
 		}
 
@@ -4410,7 +4463,7 @@ bool Game::combatChangeMana(Creature* attacker, Creature* target, CombatDamage&
 		message.primary.color = TEXTCOLOR_BLUE;
 
 		SpectatorVec spectators;
-		map.getSpectators(spectators, targetPos, false, true);
+		getCombatSpectators(spectators, targetPos, false, areaSpectators);
 		for (Creature* spectator : spectators) {
 			Player* tmpPlayer = spectator->getPlayer();
 			if (tmpPlayer == attackerPlayer && attackerPlayer != targetPlayer) {
@@ -4447,6 +4500,21 @@ bool Game::combatChangeMana(Creature* attacker, Creature* target, CombatDamage&
 	return true;
 }
 
+void Game::getCombatSpectators(SpectatorVec& spectators, const Position& pos, bool multifloor, const SpectatorVec* areaSpectators)
+{
+	if (!areaSpectators) {
+		map.getSpectators(spectators, pos, multifloor, true);
+		return;
+	}
+
+	// the area query already covers the viewport of every target inside the area
+	for (Creature* spectator : *areaSpectators) {
+		if (!spectator->isRemoved() && Map::isInViewport(pos, spectator->getPosition(), multifloor)) {
+			spectators.emplace_back(spectator);
+		}
+	}
+}
+
 void Game::addCreatureHealth(const Creature* target)
 {
 	SpectatorVec spectators;
@@ -4456,9 +4524,11 @@ void Game::addCreatureHealth(const Creature* target)
 
 void Game::addCreatureHealth(const SpectatorVec& spectators, const Creature* target)
 {
+	NetworkMessage msg;
+	ProtocolGame::AddCreatureHealth(msg, target);
 	for (Creature* spectator : spectators) {
 		if (Player* tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendCreatureHealth(target);
+			tmpPlayer->sendNetworkMessage(msg);
 		}
 	}
 }
@@ -4472,9 +4542,13 @@ void Game::addMagicEffect(const Position& pos, uint8_t effect)
 
 void Game::addMagicEffect(const SpectatorVec& spectators, const Position& pos, uint8_t effect)
 {
+	NetworkMessage msg;
+	ProtocolGame::AddMagicEffect(msg, pos, effect);
 	for (Creature* spectator : spectators) {
 		if (Player* tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendMagicEffect(pos, effect);
+			if (tmpPlayer->canSee(pos)) {
+				tmpPlayer->sendNetworkMessage(msg);
+			}
 		}
 	}
 }
@@ -4491,9 +4565,11 @@ void Game::addDistanceEffect(const Position& fromPos, const Position& toPos, uin
 
 void Game::addDistanceEffect(const SpectatorVec& spectators, const Position& fromPos, const Position& toPos, uint8_t effect)
 {
+	NetworkMessage msg;
+	ProtocolGame::AddDistanceShoot(msg, fromPos, toPos, effect);
 	for (Creature* spectator : spectators) {
 		if (Player* tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect);
+			tmpPlayer->sendNetworkMessage(msg);
 		}
 	}
 }
@@ -4536,6 +4612,8 @@ void Game::checkDecay()
 {
 	g_scheduler.addEvent(createSchedulerTask(EVENT_DECAYINTERVAL, std::bind(&Game::checkDecay, this)));
 
+	MetricTimer timer(g_metrics.decayTick);
+
 	size_t bucket = (lastBucket + 1) % EVENT_DECAY_BUCKETS;
 
 	auto it = decayItems[bucket].begin(), end = decayItems[bucket].end();
@@ -4614,6 +4692,9 @@ void Game::shutdown()
 
 	g_scheduler.shutdown();
 	g_databaseTasks.shutdown();
+	g_cryptoTasks.shutdown();
+	g_workerPool.shutdown();
+	g_lagWatchdog.shutdown();
 	g_dispatcher.shutdown();
 	map.spawns.clear();
 	raids.clear();
@@ -4666,8 +4747,11 @@ void Game::ReleaseItem(Item* item)
 void Game::broadcastMessage(const std::string& text, MessageClasses type) const
 {
 	std::cout << "> Broadcasted message: \"" << text << "\"." << std::endl;
+
+	NetworkMessage msg;
+	ProtocolGame::AddTextMessage(msg, TextMessage(type, text));
 	for (const auto& it : players) {
-		it.second->sendTextMessage(type, text);
+		it.second->sendNetworkMessage(msg);
 	}
 }
 
@@ -68,6 +68,9 @@ static constexpr int32_t EVENT_WORLDTIMEINTERVAL = 2500;
 static constexpr int32_t EVENT_DECAYINTERVAL = 250;
 static constexpr int32_t EVENT_DECAY_BUCKETS = 4;
 
+// below this many follow path searches per tick the worker pool is not worth waking
+static constexpr size_t MIN_PARALLEL_FOLLOW_PATHS = 8;
+
 /**
   * Main Game class.
   * This class is responsible to control everything that happens
@@ -221,6 +224,9 @@ class Game
 		size_t getNpcsOnline() const {
 			return npcs.size();
 		}
+		// creatures polled by checkCreatures versus monsters descheduled until a target shows up
+		size_t getActiveCreatureCount() const;
+		size_t getIdleMonsterCount() const;
 		uint32_t getPlayersRecord() const {
 			return playersRecord;
 		}
@@ -445,8 +451,8 @@ class Game
 
 		void combatGetTypeInfo(CombatType_t combatType, Creature* target, TextColor_t& color, uint8_t& effect);
 
-		bool combatChangeHealth(Creature* attacker, Creature* target, CombatDamage& damage);
-		bool combatChangeMana(Creature* attacker, Creature* target, CombatDamage& damage);
+		bool combatChangeHealth(Creature* attacker, Creature* target, CombatDamage& damage, const SpectatorVec* areaSpectators = nullptr);
+		bool combatChangeMana(Creature* attacker, Creature* target, CombatDamage& damage, const SpectatorVec* areaSpectators = nullptr);
 
 		//animation help functions
 		void addCreatureHealth(const Creature* target);
@@ -471,6 +477,7 @@ class Game
 
 		const std::unordered_map<uint32_t, Player*>& getPlayers() const { return players; }
 		const std::map<uint32_t, Npc*>& getNpcs() const { return npcs; }
+		const std::map<uint32_t, Monster*>& getMonsters() const { return monsters; }
 
 		void addPlayer(Player* player);
 		void removePlayer(Player* player);
@@ -531,6 +538,9 @@ class Game
 		void checkDecay();
 		void internalDecayItem(Item* item);
 
+		// players seeing pos, narrowed from the area spectators when given
+		void getCombatSpectators(SpectatorVec& spectators, const Position& pos, bool multifloor, const SpectatorVec* areaSpectators);
+
 		std::unordered_map<uint32_t, Player*> players;
 		std::unordered_map<std::string, Player*> mappedPlayerNames;
 		std::unordered_map<uint32_t, Player*> mappedPlayerGuids;
@@ -539,7 +549,8 @@ class Game
 		std::map<uint32_t, uint32_t> stages;
 
 		std::list<Item*> decayItems[EVENT_DECAY_BUCKETS];
-		std::list<Creature*> checkCreatureLists[EVENT_CREATURECOUNT];
+		std::vector<Creature*> checkCreatureLists[EVENT_CREATURECOUNT];
+		std::vector<Creature*> followPathCandidates;
 
 		std::vector<Creature*> ToReleaseCreatures;
 		std::vector<Item*> ToReleaseItems;
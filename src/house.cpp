@@ -35,6 +35,7 @@ House::House(uint32_t houseId) : id(houseId) {}
 void House::addTile(HouseTile* tile)
 {
 	tile->setFlag(TILESTATE_PROTECTIONZONE);
+	g_game.map.updateWalkMask(tile);
 	houseTiles.push_back(tile);
 }
 
@@ -22,6 +22,7 @@
 #include "iologindata.h"
 #include "configmanager.h"
 #include "game.h"
+#include "tracing.h"
 
 extern ConfigManager g_config;
 extern Game g_game;
@@ -650,6 +651,11 @@ bool IOLoginData::saveItems(const Player* player, const ItemBlockList& itemList,
 
 bool IOLoginData::savePlayer(Player* player)
 {
+	TraceSpan span("savePlayer");
+	if (span.isActive()) {
+		span.setDetail(player->getName());
+	}
+
 	if (player->getHealth() <= 0) {
 		player->changeHealth(1);
 	}
@@ -912,30 +918,57 @@ bool IOLoginData::savePlayer(Player* player)
 		return false;
 	}
 
-	query.str(std::string());
-	query << "DELETE FROM `player_storage` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
+	//only the storage values changed since the last save are written
+	player->genReservedStorageRange();
+
+	StorageTable& storage = player->storage;
+	if (!storage.getErasedKeys().empty()) {
+		query.str(std::string());
+		query << "DELETE FROM `player_storage` WHERE `player_id` = " << player->getGUID() << " AND `key` IN (";
+
+		bool first = true;
+		for (uint32_t key : storage.getErasedKeys()) {
+			if (first) {
+				first = false;
+			} else {
+				query << ',';
+			}
+			query << key;
+		}
+		query << ')';
+
+		if (!db.executeQuery(query.str())) {
+			return false;
+		}
 	}
 
 	query.str(std::string());
 
-	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
-	player->genReservedStorageRange();
+	if (storage.isDirty()) {
+		DBInsert storageQuery("REPLACE INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
+		for (const StorageTable::Entry& entry : storage) {
+			if (!entry.dirty) {
+				continue;
+			}
+
+			query << player->getGUID() << ',' << entry.key << ',' << entry.value;
+			if (!storageQuery.addRow(query)) {
+				return false;
+			}
+		}
 
-	for (const auto& it : player->storageMap) {
-		query << player->getGUID() << ',' << it.first << ',' << it.second;
-		if (!storageQuery.addRow(query)) {
+		if (!storageQuery.execute()) {
 			return false;
 		}
 	}
 
-	if (!storageQuery.execute()) {
+	//End the transaction
+	if (!transaction.commit()) {
 		return false;
 	}
 
-	//End the transaction
-	return transaction.commit();
+	storage.clearDirty();
+	return true;
 }
 
 std::string IOLoginData::getNameByGuid(uint32_t guid)
@@ -253,8 +253,12 @@ void Item::onRemoved()
 
 void Item::setID(uint16_t newid)
 {
+	Player* player = getCarryingPlayer();
+	updateHolderItemCounts(player, false);
+
 	const ItemType& prevIt = Item::items[id];
 	id = newid;
+	updateHolderItemCounts(player, true);
 
 	const ItemType& it = Item::items[newid];
 	uint32_t newDuration = it.decayTime * 1000;
@@ -356,6 +360,38 @@ Player* Item::getHoldingPlayer() const
 	return nullptr;
 }
 
+Player* Item::getCarryingPlayer() const
+{
+	const Item* item = this;
+	Cylinder* p = getParent();
+	while (p && !p->getCreature()) {
+		item = p->getItem();
+		if (!item) {
+			return nullptr;
+		}
+
+		p = p->getParent();
+	}
+
+	if (!p) {
+		return nullptr;
+	}
+
+	// the store inbox has the player as parent too, but is not carried
+	if (p->getThingIndex(item) == -1) {
+		return nullptr;
+	}
+	return p->getCreature()->getPlayer();
+}
+
+void Item::setItemCount(uint8_t n)
+{
+	Player* player = getCarryingPlayer();
+	updateHolderItemCounts(player, false);
+	count = n;
+	updateHolderItemCounts(player, true);
+}
+
 void Item::setSubType(uint16_t n)
 {
 	const ItemType& it = items[id];
@@ -2515,6 +2551,42 @@ void Item::setUniqueId(uint16_t n)
 
 	if (g_game.addUniqueItem(n, this)) {
 		getAttributes()->setUniqueId(n);
+		updateTileMoveEvents();
+	}
+}
+
+void Item::updateTileMoveEvents()
+{
+	// tiles only look up move events when one of their items may have any,
+	// so an id assigned to an item already lying on a tile has to flag it
+	if (!parent) {
+		return;
+	}
+
+	Tile* tile = parent->getTile();
+	if (tile && tile == parent) {
+		tile->setFlag(TILESTATE_MOVEEVENTS);
+	}
+}
+
+void Item::updateTileDescription()
+{
+	// attributes changed outside of the tile methods, which drop the cache themselves
+	if (!parent) {
+		return;
+	}
+
+	Tile* tile = parent->getTile();
+	if (tile && tile == parent) {
+		tile->invalidateDescriptionCache();
+	}
+}
+
+void Item::updateHolderItemCounts(Player* player, bool add)
+{
+	// take the item out of the carried counts before a change to its id, count or subtype, and put it back after
+	if (player) {
+		player->updateItemTypeCount(this, add);
 	}
 }
 
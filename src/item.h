@@ -25,6 +25,7 @@
 #include "items.h"
 #include "luascript.h"
 #include "tools.h"
+#include "objectpool.h"
 #include <typeinfo>
 
 #include <boost/variant.hpp>
@@ -577,6 +578,14 @@ class Item : virtual public Thing
 
 		virtual ~Item() = default;
 
+		// items of every class are carved from the item slabs
+		static void* operator new(size_t size) {
+			return getItemAllocator().allocate(size);
+		}
+		static void operator delete(void* p, size_t size) {
+			getItemAllocator().deallocate(p, size);
+		}
+
 		// non-assignable
 		Item& operator=(const Item&) = delete;
 
@@ -643,15 +652,40 @@ class Item : virtual public Thing
 			return attributes->getIntAttr(type);
 		}
 		void setIntAttr(itemAttrTypes type, uint64_t value) {
+			Player* player = nullptr;
+			if (type == ITEM_ATTRIBUTE_CHARGES || type == ITEM_ATTRIBUTE_FLUIDTYPE) {
+				player = getCarryingPlayer();
+				updateHolderItemCounts(player, false);
+			}
+
 			getAttributes()->setIntAttr(type, value);
+			if (type == ITEM_ATTRIBUTE_ACTIONID) {
+				updateTileMoveEvents();
+				updateTileDescription();
+			} else if (type == ITEM_ATTRIBUTE_CHARGES || type == ITEM_ATTRIBUTE_FLUIDTYPE) {
+				updateHolderItemCounts(player, true);
+				updateTileDescription();
+			}
 		}
 		void increaseIntAttr(itemAttrTypes type, uint64_t value) {
 			getAttributes()->increaseIntAttr(type, value);
 		}
 
 		void removeAttribute(itemAttrTypes type) {
-			if (attributes) {
-				attributes->removeAttribute(type);
+			if (!attributes) {
+				return;
+			}
+
+			Player* player = nullptr;
+			if (type == ITEM_ATTRIBUTE_CHARGES || type == ITEM_ATTRIBUTE_FLUIDTYPE) {
+				player = getCarryingPlayer();
+				updateHolderItemCounts(player, false);
+			}
+
+			attributes->removeAttribute(type);
+			if (type == ITEM_ATTRIBUTE_CHARGES || type == ITEM_ATTRIBUTE_FLUIDTYPE) {
+				updateHolderItemCounts(player, true);
+				updateTileDescription();
 			}
 		}
 		bool hasAttribute(itemAttrTypes type) const {
@@ -861,6 +895,8 @@ class Item : virtual public Thing
 
 		// Returns the player that is holding this item in his inventory
 		Player* getHoldingPlayer() const;
+		// the player holding this item in an inventory slot, directly or in a container
+		Player* getCarryingPlayer() const;
 
 		WeaponType_t getWeaponType() const {
 			return items[id].weaponType;
@@ -1291,9 +1327,7 @@ class Item : virtual public Thing
 		uint16_t getItemCount() const {
 			return count;
 		}
-		void setItemCount(uint8_t n) {
-			count = n;
-		}
+		void setItemCount(uint8_t n);
 
 		static uint32_t countByType(const Item* i, int32_t subType) {
 			if (subType == -1 || subType == i->getSubType()) {
@@ -1380,6 +1414,9 @@ class Item : virtual public Thing
 
 	private:
 		std::string getWeightDescription(uint32_t weight) const;
+		void updateTileMoveEvents();
+		void updateTileDescription();
+		void updateHolderItemCounts(Player* player, bool add);
 
 		std::unique_ptr<ItemAttributes> attributes;
 
@@ -23,6 +23,7 @@
 #include "spells.h"
 #include "movement.h"
 #include "weapons.h"
+#include "tile.h"
 
 #include "pugicast.h"
 
@@ -267,6 +268,7 @@ bool Items::reload()
 	g_moveEvents->reload();
 	g_weapons->reload();
 	g_weapons->loadDefaults();
+	TileDescriptionCache::invalidateAll();
 	return true;
 }
 
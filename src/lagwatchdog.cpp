@@ -0,0 +1,294 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "lagwatchdog.h"
+#include "luascript.h"
+#include "tasks.h"
+#include "tools.h"
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <csignal>
+#include <execinfo.h>
+#include <pthread.h>
+#endif
+
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+namespace {
+
+const std::string LAG_LOG_FILE = "lagspikes.log";
+constexpr std::streamoff LAG_LOG_MAX_SIZE = 1024 * 1024;
+constexpr int LAG_LOG_FILES = 5;
+
+constexpr int LAG_SAMPLE_MAX_FRAMES = 64;
+constexpr auto LAG_SAMPLE_TIMEOUT = std::chrono::milliseconds(100);
+
+#ifdef SIGRTMIN
+// a realtime signal leaves SIGPROF to profilers like gperftools
+#define LAG_SAMPLE_SIGNAL (SIGRTMIN + 1)
+#else
+#define LAG_SAMPLE_SIGNAL SIGPROF
+#endif
+
+// filled by the signal handler on the dispatcher thread, the watchdog reads it once ready
+struct LagSample
+{
+	void* frames[LAG_SAMPLE_MAX_FRAMES];
+	int frameCount = 0;
+	uint64_t cycle = 0;
+	const std::type_info* taskType = nullptr;
+	const char* taskTag = nullptr;
+	uint32_t playerId = 0;
+	bool inScript = false;
+	int32_t scriptId = 0;
+	int32_t callbackId = 0;
+	bool timerEvent = false;
+	LuaScriptInterface* scriptInterface = nullptr;
+};
+
+LagSample sample;
+std::atomic<bool> sampleRequested{false};
+std::atomic<bool> sampleReady{false};
+
+#ifndef _WIN32
+pthread_t dispatcherThread;
+std::atomic<bool> hasDispatcherThread{false};
+#endif
+
+std::string demangle(const char* name)
+{
+#ifdef __GNUC__
+	int status = 0;
+	char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+	if (status == 0 && demangled) {
+		std::string result(demangled);
+		free(demangled);
+		return result;
+	}
+#endif
+	return name;
+}
+
+void writeEntry(const std::string& entry)
+{
+	std::streamoff size;
+	{
+		std::ofstream file(LAG_LOG_FILE, std::ios::app);
+		if (!file.is_open()) {
+			std::cout << "[Error - LagWatchdog::report] Unable to write " << LAG_LOG_FILE << std::endl;
+			return;
+		}
+		file << entry;
+		size = file.tellp();
+	}
+
+	if (size < LAG_LOG_MAX_SIZE) {
+		return;
+	}
+
+	// lagspikes.log becomes lagspikes.log.1, the oldest file is dropped
+	std::remove((LAG_LOG_FILE + '.' + std::to_string(LAG_LOG_FILES)).c_str());
+	for (int i = LAG_LOG_FILES - 1; i > 0; --i) {
+		std::rename((LAG_LOG_FILE + '.' + std::to_string(i)).c_str(), (LAG_LOG_FILE + '.' + std::to_string(i + 1)).c_str());
+	}
+	std::rename(LAG_LOG_FILE.c_str(), (LAG_LOG_FILE + ".1").c_str());
+}
+
+}
+
+void LagWatchdog::start(uint32_t threshold)
+{
+	if (threshold == 0) {
+		return;
+	}
+
+	this->threshold = std::chrono::milliseconds(threshold);
+
+#ifndef _WIN32
+	// the first backtrace call may load libgcc, which is not safe inside a signal handler
+	void* frame;
+	backtrace(&frame, 1);
+
+	struct sigaction action = {};
+	action.sa_handler = sampleDispatcher;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	sigaction(LAG_SAMPLE_SIGNAL, &action, nullptr);
+#endif
+
+	ThreadHolder::start();
+}
+
+void LagWatchdog::shutdown()
+{
+	std::lock_guard<std::mutex> lockClass(watchLock);
+	setState(THREAD_STATE_TERMINATED);
+	watchSignal.notify_one();
+}
+
+void LagWatchdog::setDispatcherThread()
+{
+#ifndef _WIN32
+	dispatcherThread = pthread_self();
+	hasDispatcherThread.store(true, std::memory_order_release);
+#endif
+}
+
+void LagWatchdog::threadMain()
+{
+	const auto interval = std::max<std::chrono::milliseconds>(threshold / 4, std::chrono::milliseconds(10));
+
+	std::unique_lock<std::mutex> watchLockUnique(watchLock);
+	while (getState() != THREAD_STATE_TERMINATED) {
+		watchSignal.wait_for(watchLockUnique, interval);
+		if (getState() == THREAD_STATE_TERMINATED || !runningTask.load(std::memory_order_acquire)) {
+			continue;
+		}
+
+		const uint64_t cycle = runningCycle.load(std::memory_order_relaxed);
+		if (cycle == reportedCycle) {
+			continue;
+		}
+
+		const std::chrono::steady_clock::time_point since{std::chrono::steady_clock::duration{runningSince.load(std::memory_order_relaxed)}};
+		const auto runningFor = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since);
+		if (runningFor < threshold) {
+			continue;
+		}
+
+		reportedCycle = cycle;
+		watchLockUnique.unlock();
+		report(cycle, runningFor);
+		watchLockUnique.lock();
+	}
+}
+
+void LagWatchdog::sampleDispatcher(int)
+{
+	//dispatcher thread, inside a signal handler
+	if (!sampleRequested.exchange(false)) {
+		return;
+	}
+
+	// the task cannot finish while its own thread runs this handler
+	Task* task = g_lagWatchdog.runningTask.load(std::memory_order_relaxed);
+	sample.cycle = g_lagWatchdog.runningCycle.load(std::memory_order_relaxed);
+	sample.taskType = task ? &task->getType() : nullptr;
+	sample.taskTag = task ? task->getTag() : nullptr;
+	sample.playerId = task ? task->getPlayerId() : 0;
+
+	sample.inScript = LuaScriptInterface::isScriptRunning();
+	if (sample.inScript) {
+		LuaScriptInterface::getScriptEnv()->getEventInfo(sample.scriptId, sample.scriptInterface, sample.callbackId, sample.timerEvent);
+	}
+
+#ifndef _WIN32
+	sample.frameCount = backtrace(sample.frames, LAG_SAMPLE_MAX_FRAMES);
+#endif
+
+	sampleReady.store(true, std::memory_order_release);
+}
+
+void LagWatchdog::report(uint64_t cycle, std::chrono::milliseconds runningFor)
+{
+	bool sampled = false;
+	bool finishedEarly = false;
+#ifndef _WIN32
+	if (hasDispatcherThread.load(std::memory_order_acquire)) {
+		sampleReady.store(false, std::memory_order_relaxed);
+		sampleRequested.store(true);
+		pthread_kill(dispatcherThread, LAG_SAMPLE_SIGNAL);
+
+		const auto deadline = std::chrono::steady_clock::now() + LAG_SAMPLE_TIMEOUT;
+		while (!sampleReady.load(std::memory_order_acquire) && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		if (sampleRequested.exchange(false)) {
+			// the handler never ran
+		} else {
+			while (!sampleReady.load(std::memory_order_acquire)) {
+				std::this_thread::yield();
+			}
+
+			// the overrun was measured, a sample of the next task would only be misleading
+			finishedEarly = sample.cycle != cycle;
+			sampled = !finishedEarly;
+		}
+	}
+#endif
+
+	std::cout << "[Warning - LagWatchdog::report] Dispatcher task running for " << runningFor.count() << " ms, details written to " << LAG_LOG_FILE << std::endl;
+
+	std::ostringstream ss;
+	ss << '[' << formatDate(time(nullptr)) << "] Dispatcher task running for " << runningFor.count() << " ms (threshold " << threshold.count() << " ms)" << std::endl;
+	if (finishedEarly) {
+		ss << "Task finished before it could be sampled." << std::endl << std::endl;
+		writeEntry(ss.str());
+		return;
+	}
+
+	if (!sampled) {
+		ss << "No sample of the dispatcher could be taken." << std::endl << std::endl;
+		writeEntry(ss.str());
+		return;
+	}
+
+	if (sample.taskTag) {
+		ss << "Task: " << sample.taskTag << std::endl;
+	} else if (sample.taskType) {
+		ss << "Task: " << demangle(sample.taskType->name()) << std::endl;
+	}
+
+	if (sample.playerId != 0) {
+		ss << "Player id: " << sample.playerId << std::endl;
+	}
+
+	if (sample.inScript && sample.scriptInterface) {
+		// the dispatcher is most likely still in the slow task, the file cache only changes on reloads
+		ss << "Lua: [" << sample.scriptInterface->getInterfaceName() << "] " << sample.scriptInterface->getFileById(sample.scriptId);
+		if (sample.callbackId) {
+			ss << " in callback " << sample.scriptInterface->getFileById(sample.callbackId);
+		}
+		if (sample.timerEvent) {
+			ss << " from a timer event";
+		}
+		ss << std::endl;
+	}
+
+#ifndef _WIN32
+	ss << "Stack:" << std::endl;
+	if (char** symbols = backtrace_symbols(sample.frames, sample.frameCount)) {
+		// the first frames belong to the signal handler
+		for (int i = 0; i < sample.frameCount; ++i) {
+			ss << "  " << symbols[i] << std::endl;
+		}
+		free(symbols);
+	}
+#endif
+	ss << std::endl;
+
+	writeEntry(ss.str());
+}
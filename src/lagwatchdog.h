@@ -0,0 +1,69 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_LAGWATCHDOG_H_A4716E3D2A0A419BB0B57AE8F822EB7A
+#define FS_LAGWATCHDOG_H_A4716E3D2A0A419BB0B57AE8F822EB7A
+
+#include <condition_variable>
+#include "thread_holder_base.h"
+
+class Task;
+
+// Watches the dispatcher from its own thread. A task running past the
+// threshold is sampled once, with its type, player, running Lua script and
+// native stack, and written to a rotating log. The dispatcher only publishes
+// which task runs and since when, tasks within budget pay nothing else.
+class LagWatchdog : public ThreadHolder<LagWatchdog>
+{
+	public:
+		// a threshold of 0 leaves the watchdog off
+		void start(uint32_t threshold);
+		void shutdown();
+
+		void threadMain();
+
+		//dispatcher thread
+		void setDispatcherThread();
+		void taskStarted(Task* task, uint64_t cycle, std::chrono::steady_clock::time_point start) {
+			runningSince.store(start.time_since_epoch().count(), std::memory_order_relaxed);
+			runningCycle.store(cycle, std::memory_order_relaxed);
+			runningTask.store(task, std::memory_order_release);
+		}
+		void taskFinished() {
+			runningTask.store(nullptr, std::memory_order_relaxed);
+		}
+
+	private:
+		static void sampleDispatcher(int);
+		void report(uint64_t cycle, std::chrono::milliseconds runningFor);
+
+		std::atomic<Task*> runningTask{nullptr};
+		std::atomic<uint64_t> runningCycle{0};
+		std::atomic<std::chrono::steady_clock::rep> runningSince{0};
+
+		std::chrono::milliseconds threshold{0};
+		uint64_t reportedCycle = 0;
+
+		std::mutex watchLock;
+		std::condition_variable watchSignal;
+};
+
+extern LagWatchdog g_lagWatchdog;
+
+#endif
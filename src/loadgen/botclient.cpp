@@ -0,0 +1,504 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "botclient.h"
+#include "enums.h"
+#include "rsa.h"
+
+#include <zlib.h>
+
+namespace {
+
+constexpr uint32_t PONG_INTERVAL = 5000;
+constexpr uint32_t RECONNECT_DELAY = 5000;
+
+uint32_t checksum(const uint8_t* data, size_t length)
+{
+	return adler32(1, data, length);
+}
+
+}
+
+// LoadStats
+
+void LoadStats::addRoundTrip(uint32_t micros)
+{
+	std::lock_guard<std::mutex> lockClass(sampleLock);
+	roundTrips.push_back(micros);
+}
+
+std::vector<uint32_t> LoadStats::takeRoundTrips()
+{
+	std::vector<uint32_t> samples;
+
+	std::lock_guard<std::mutex> lockClass(sampleLock);
+	samples.swap(roundTrips);
+	return samples;
+}
+
+// BotClient
+
+BotClient::BotClient(boost::asio::io_service& io_service, const LoadgenOptions& options, const RSA& rsa,
+                     LoadStats& stats, std::vector<std::atomic<uint32_t>>& playerIds, uint32_t index) :
+	socket(io_service), timer(io_service), options(options), rsa(rsa), stats(stats), playerIds(playerIds),
+	generator(std::random_device{}()), index(index)
+{
+	characterName = options.characterPrefix + std::to_string(options.firstBot + index);
+}
+
+void BotClient::start()
+{
+	connect();
+}
+
+void BotClient::stop()
+{
+	timer.cancel();
+
+	if (state == STATE_ONLINE) {
+		setOffline();
+		state = STATE_STOPPED;
+
+		// the socket is closed by onWrite once the logout is out
+		NetworkMessage msg;
+		msg.addByte(0x14);
+		sendPacket(msg);
+		return;
+	}
+
+	state = STATE_STOPPED;
+	closeSocket();
+}
+
+void BotClient::connect()
+{
+	state = STATE_CONNECTING;
+	input.reset();
+	outputQueue.clear();
+	probePending = false;
+
+	boost::system::error_code error;
+	auto address = boost::asio::ip::address::from_string(options.host, error);
+	if (error) {
+		std::cout << "[Error - BotClient::connect] Invalid address " << options.host << '.' << std::endl;
+		state = STATE_STOPPED;
+		return;
+	}
+
+	socket.async_connect(boost::asio::ip::tcp::endpoint(address, options.gamePort),
+	                     std::bind(&BotClient::onConnect, shared_from_this(), std::placeholders::_1));
+}
+
+void BotClient::onConnect(const boost::system::error_code& error)
+{
+	if (state == STATE_STOPPED) {
+		return;
+	}
+
+	if (error) {
+		stats.loginFailures++;
+		reconnect(RECONNECT_DELAY);
+		return;
+	}
+
+	socket.set_option(boost::asio::ip::tcp::no_delay(true));
+	state = STATE_CHALLENGE;
+	readHeader();
+}
+
+void BotClient::reconnect(uint32_t delay)
+{
+	setOffline();
+	closeSocket();
+	state = STATE_CONNECTING;
+
+	timer.expires_from_now(std::chrono::milliseconds(delay));
+	timer.async_wait([self = shared_from_this()](const boost::system::error_code& error) {
+		if (!error && self->state != STATE_STOPPED) {
+			self->connect();
+		}
+	});
+}
+
+void BotClient::setOffline()
+{
+	if (state == STATE_ONLINE) {
+		stats.online--;
+		playerIds[index] = 0;
+	}
+}
+
+void BotClient::closeSocket()
+{
+	boost::system::error_code error;
+	socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, error);
+	socket.close(error);
+}
+
+void BotClient::readHeader()
+{
+	boost::asio::async_read(socket, boost::asio::buffer(input.getBuffer(), NetworkMessage::HEADER_LENGTH),
+	                        std::bind(&BotClient::onReadHeader, shared_from_this(), std::placeholders::_1));
+}
+
+void BotClient::onReadHeader(const boost::system::error_code& error)
+{
+	if (state == STATE_STOPPED) {
+		return;
+	}
+
+	uint16_t size = input.getLengthHeader();
+	if (error || size < NetworkMessage::CHECKSUM_LENGTH || size >= NETWORKMESSAGE_MAXSIZE - NetworkMessage::HEADER_LENGTH) {
+		if (state == STATE_ONLINE) {
+			stats.disconnects++;
+		}
+		reconnect(RECONNECT_DELAY);
+		return;
+	}
+
+	input.setLength(size + NetworkMessage::HEADER_LENGTH);
+	boost::asio::async_read(socket, boost::asio::buffer(input.getBodyBuffer(), size),
+	                        std::bind(&BotClient::onReadBody, shared_from_this(), std::placeholders::_1));
+}
+
+void BotClient::onReadBody(const boost::system::error_code& error)
+{
+	if (state == STATE_STOPPED) {
+		return;
+	}
+
+	if (error) {
+		if (state == STATE_ONLINE) {
+			stats.disconnects++;
+		}
+		reconnect(RECONNECT_DELAY);
+		return;
+	}
+
+	stats.bytesReceived += input.getLength();
+	stats.packetsReceived++;
+
+	// every server message starts with the checksum of the rest
+	uint32_t recvChecksum = input.get<uint32_t>();
+	const uint8_t* body = input.getBuffer() + input.getBufferPosition();
+	if (recvChecksum != checksum(body, input.getLength() - input.getBufferPosition())) {
+		std::cout << "[Warning - BotClient::onReadBody] " << characterName << " received a message with a wrong checksum." << std::endl;
+		stats.disconnects++;
+		reconnect(RECONNECT_DELAY);
+		return;
+	}
+
+	if (state == STATE_CHALLENGE) {
+		parseChallenge();
+	} else {
+		parseGamePacket();
+	}
+
+	if (state == STATE_CHALLENGE || state == STATE_LOGIN || state == STATE_ONLINE) {
+		readHeader();
+	}
+}
+
+void BotClient::parseChallenge()
+{
+	input.skipBytes(2); // inner length
+	if (input.getByte() != 0x1F) {
+		stats.loginFailures++;
+		reconnect(RECONNECT_DELAY);
+		return;
+	}
+
+	uint32_t timestamp = input.get<uint32_t>();
+	uint8_t randomNumber = input.getByte();
+	sendLogin(timestamp, randomNumber);
+	state = STATE_LOGIN;
+}
+
+void BotClient::sendLogin(uint32_t timestamp, uint8_t randomNumber)
+{
+	for (uint32_t& part : key) {
+		part = generator();
+	}
+
+	// the RSA block starts with a zero byte so that it stays below the modulus
+	NetworkMessage block;
+	block.addByte(0);
+	for (uint32_t part : key) {
+		block.add<uint32_t>(part);
+	}
+	block.addByte(0); // gamemaster flag
+
+	const std::string account = options.accountPrefix + std::to_string(options.firstBot + index);
+	block.addString(account + '\n' + options.password + "\n\n0");
+	block.addString(characterName);
+	block.add<uint32_t>(timestamp);
+	block.addByte(randomNumber);
+	while (block.getLength() < 128) {
+		block.addByte(static_cast<uint8_t>(generator()));
+	}
+
+	char* rsaBlock = reinterpret_cast<char*>(block.getBuffer()) + NetworkMessage::INITIAL_BUFFER_POSITION;
+	rsa.encrypt(rsaBlock);
+
+	NetworkMessage msg;
+	msg.addByte(0x0A); // protocol id
+	msg.add<uint16_t>(CLIENTOS_WINDOWS);
+	msg.add<uint16_t>(CLIENT_VERSION_MAX);
+	msg.add<uint32_t>(CLIENT_VERSION_MAX);
+	msg.addByte(0); // client type
+	msg.add<uint16_t>(0); // dat revision
+	msg.addBytes(rsaBlock, 128);
+
+	// unencrypted layout: length, checksum, body
+	uint8_t* buffer = msg.getBuffer();
+	const uint16_t length = msg.getLength();
+	const uint32_t bodyChecksum = checksum(buffer + NetworkMessage::INITIAL_BUFFER_POSITION, length);
+	const uint16_t size = length + NetworkMessage::CHECKSUM_LENGTH;
+	memcpy(buffer + 2, &size, sizeof(size));
+	memcpy(buffer + 4, &bodyChecksum, sizeof(bodyChecksum));
+	write(buffer + 2, size + NetworkMessage::HEADER_LENGTH);
+}
+
+void BotClient::parseGamePacket()
+{
+	const uint16_t encryptedLength = input.getLength() - input.getBufferPosition();
+	if ((encryptedLength & 7) != 0) {
+		stats.disconnects++;
+		reconnect(RECONNECT_DELAY);
+		return;
+	}
+
+	xtea::decrypt(input.getBuffer() + input.getBufferPosition(), encryptedLength, key);
+
+	uint16_t innerLength = input.get<uint16_t>();
+	if (innerLength + 2 > encryptedLength) {
+		stats.disconnects++;
+		reconnect(RECONNECT_DELAY);
+		return;
+	}
+
+	const uint8_t* payload = input.getBuffer() + input.getBufferPosition();
+	if (state == STATE_LOGIN) {
+		uint8_t opcode = input.getByte();
+		if (opcode == 0x17) {
+			playerId = input.get<uint32_t>();
+			playerIds[index] = playerId;
+			state = STATE_ONLINE;
+			stats.online++;
+			stats.logins++;
+
+			auto now = std::chrono::steady_clock::now();
+			nextProbe = now + std::chrono::milliseconds(std::uniform_int_distribution<uint32_t>(0, options.probeInterval)(generator));
+			nextPong = now + std::chrono::milliseconds(PONG_INTERVAL);
+			scheduleTick();
+		} else if (opcode == 0x16) {
+			// waiting list, the server tells us when to retry
+			input.getString();
+			reconnect(input.getByte() * 1000);
+		} else if (opcode == 0x14) {
+			std::cout << "> " << characterName << " could not log in: " << input.getString() << std::endl;
+			stats.loginFailures++;
+			state = STATE_STOPPED;
+			closeSocket();
+		}
+		return;
+	}
+
+	if (probePending) {
+		// messages are batched, so the probe line can be anywhere in the payload
+		const uint8_t* end = payload + innerLength;
+		if (std::search(payload, end, probeText.begin(), probeText.end()) != end) {
+			auto elapsed = std::chrono::steady_clock::now() - probeSent;
+			stats.addRoundTrip(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+			probePending = false;
+		}
+	}
+}
+
+void BotClient::sendPacket(NetworkMessage& msg)
+{
+	// encrypted layout: length, checksum, then inner length and body padded to the XTEA block size
+	uint8_t* buffer = msg.getBuffer();
+	const uint16_t innerLength = msg.getLength();
+	memcpy(buffer + 6, &innerLength, sizeof(innerLength));
+
+	uint16_t encryptedLength = innerLength + 2;
+	if ((encryptedLength % 8) != 0) {
+		msg.addPaddingBytes(8 - (encryptedLength % 8));
+		encryptedLength += 8 - (encryptedLength % 8);
+	}
+
+	xtea::encrypt(buffer + 6, encryptedLength, key);
+
+	const uint32_t bodyChecksum = checksum(buffer + 6, encryptedLength);
+	const uint16_t size = encryptedLength + NetworkMessage::CHECKSUM_LENGTH;
+	memcpy(buffer, &size, sizeof(size));
+	memcpy(buffer + 2, &bodyChecksum, sizeof(bodyChecksum));
+	write(buffer, size + NetworkMessage::HEADER_LENGTH);
+}
+
+void BotClient::write(const uint8_t* data, size_t size)
+{
+	stats.bytesSent += size;
+	stats.packetsSent++;
+
+	bool noPendingWrite = outputQueue.empty();
+	outputQueue.emplace_back(data, data + size);
+	if (noPendingWrite) {
+		const auto& front = outputQueue.front();
+		boost::asio::async_write(socket, boost::asio::buffer(front.data(), front.size()),
+		                         std::bind(&BotClient::onWrite, shared_from_this(), std::placeholders::_1));
+	}
+}
+
+void BotClient::onWrite(const boost::system::error_code& error)
+{
+	if (error) {
+		outputQueue.clear();
+	} else if (!outputQueue.empty()) {
+		outputQueue.pop_front();
+	}
+
+	if (!outputQueue.empty()) {
+		const auto& front = outputQueue.front();
+		boost::asio::async_write(socket, boost::asio::buffer(front.data(), front.size()),
+		                         std::bind(&BotClient::onWrite, shared_from_this(), std::placeholders::_1));
+	} else if (state == STATE_STOPPED) {
+		closeSocket();
+	}
+}
+
+void BotClient::scheduleTick()
+{
+	// +-25% jitter keeps the bots from acting in lockstep
+	uint32_t jitter = options.actionInterval / 4;
+	uint32_t delay = options.actionInterval - jitter + std::uniform_int_distribution<uint32_t>(0, 2 * jitter)(generator);
+
+	timer.expires_from_now(std::chrono::milliseconds(std::max<uint32_t>(1, delay)));
+	timer.async_wait(std::bind(&BotClient::onTick, shared_from_this(), std::placeholders::_1));
+}
+
+void BotClient::onTick(const boost::system::error_code& error)
+{
+	if (error || state != STATE_ONLINE) {
+		return;
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	if (now >= nextPong) {
+		// keeps the server from logging idle bots out
+		NetworkMessage msg;
+		msg.addByte(0x1E);
+		sendPacket(msg);
+		nextPong = now + std::chrono::milliseconds(PONG_INTERVAL);
+	}
+
+	if (options.probeInterval != 0 && now >= nextProbe) {
+		sendProbe();
+		nextProbe = now + std::chrono::milliseconds(options.probeInterval);
+	}
+
+	uint32_t totalWeight = options.walkWeight + options.attackWeight + options.spellWeight;
+	if (totalWeight != 0) {
+		uint32_t roll = std::uniform_int_distribution<uint32_t>(0, totalWeight - 1)(generator);
+		if (roll < options.walkWeight) {
+			walk();
+		} else if (roll < options.walkWeight + options.attackWeight) {
+			attack();
+		} else {
+			castSpell();
+		}
+	}
+
+	scheduleTick();
+}
+
+void BotClient::walk()
+{
+	// patrol a square around the login position: north, east, south, west
+	static constexpr uint8_t directions[] = {0x65, 0x66, 0x67, 0x68};
+
+	uint32_t side = std::max<uint32_t>(1, options.walkSquare);
+	NetworkMessage msg;
+	msg.addByte(directions[(walkStep / side) % 4]);
+	sendPacket(msg);
+	walkStep = (walkStep + 1) % (side * 4);
+}
+
+void BotClient::attack()
+{
+	NetworkMessage msg;
+	if (attackTarget != 0) {
+		attackTarget = 0;
+		msg.addByte(0xBE); // cancel attack and follow
+		sendPacket(msg);
+		return;
+	}
+
+	// the other bots are the only creatures we know the ids of
+	uint32_t count = playerIds.size();
+	if (count < 2) {
+		return;
+	}
+
+	uint32_t other = (index + 1 + std::uniform_int_distribution<uint32_t>(0, count - 2)(generator)) % count;
+	attackTarget = playerIds[other];
+	if (attackTarget == 0) {
+		return;
+	}
+
+	msg.addByte(0xA1);
+	msg.add<uint32_t>(attackTarget);
+	msg.add<uint32_t>(attackTarget);
+	sendPacket(msg);
+}
+
+void BotClient::castSpell()
+{
+	if (options.spellWords.empty()) {
+		return;
+	}
+
+	say(options.spellWords[std::uniform_int_distribution<size_t>(0, options.spellWords.size() - 1)(generator)]);
+}
+
+void BotClient::sendProbe()
+{
+	if (probePending) {
+		stats.lostProbes++;
+	}
+
+	std::ostringstream ss;
+	ss << "loadgen " << (options.firstBot + index) << ':' << ++probeSequence;
+	probeText = ss.str();
+	probeSent = std::chrono::steady_clock::now();
+	probePending = true;
+	say(probeText);
+}
+
+void BotClient::say(const std::string& text)
+{
+	NetworkMessage msg;
+	msg.addByte(0x96);
+	msg.addByte(TALKTYPE_SAY);
+	msg.addString(text);
+	sendPacket(msg);
+}
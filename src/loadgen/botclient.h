@@ -0,0 +1,164 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_BOTCLIENT_H_683C21A9EC8D4240BB30D80960FB90F0
+#define FS_BOTCLIENT_H_683C21A9EC8D4240BB30D80960FB90F0
+
+#include <atomic>
+#include <deque>
+#include <random>
+
+#include "networkmessage.h"
+#include "xtea.h"
+
+class RSA;
+
+struct LoadgenOptions
+{
+	std::string host = "127.0.0.1";
+	uint16_t gamePort = 7172;
+	uint16_t metricsPort = 0;
+	std::string keyFile = "key.pem";
+
+	uint32_t bots = 10;
+	uint32_t firstBot = 1;
+	std::string accountPrefix = "loadgen";
+	std::string password = "loadgen";
+	std::string characterPrefix = "Loadgen ";
+
+	uint32_t threads = 1;
+	uint32_t duration = 60;
+	uint32_t loginsPerSecond = 10;
+	uint32_t reportInterval = 10;
+
+	// every action tick picks one of the weighted patterns
+	uint32_t actionInterval = 500;
+	uint32_t walkWeight = 60;
+	uint32_t attackWeight = 10;
+	uint32_t spellWeight = 10;
+	uint32_t walkSquare = 3;
+	std::vector<std::string> spellWords = {"exura"};
+
+	// chat lines double as round trip probes, the speaker receives its own line back
+	uint32_t probeInterval = 2000;
+};
+
+class LoadStats
+{
+	public:
+		void addRoundTrip(uint32_t micros);
+		// moves the samples collected since the last call out
+		std::vector<uint32_t> takeRoundTrips();
+
+		std::atomic<uint64_t> bytesSent{0};
+		std::atomic<uint64_t> bytesReceived{0};
+		std::atomic<uint64_t> packetsSent{0};
+		std::atomic<uint64_t> packetsReceived{0};
+
+		std::atomic<uint32_t> online{0};
+		std::atomic<uint32_t> logins{0};
+		std::atomic<uint32_t> loginFailures{0};
+		std::atomic<uint32_t> disconnects{0};
+		std::atomic<uint32_t> lostProbes{0};
+
+	private:
+		std::mutex sampleLock;
+		std::vector<uint32_t> roundTrips;
+};
+
+class BotClient : public std::enable_shared_from_this<BotClient>
+{
+	public:
+		BotClient(boost::asio::io_service& io_service, const LoadgenOptions& options, const RSA& rsa,
+		          LoadStats& stats, std::vector<std::atomic<uint32_t>>& playerIds, uint32_t index);
+
+		// non-copyable
+		BotClient(const BotClient&) = delete;
+		BotClient& operator=(const BotClient&) = delete;
+
+		void start();
+		void stop();
+
+	private:
+		enum State {
+			STATE_CONNECTING,
+			STATE_CHALLENGE,
+			STATE_LOGIN,
+			STATE_ONLINE,
+			STATE_STOPPED,
+		};
+
+		void connect();
+		void onConnect(const boost::system::error_code& error);
+		void reconnect(uint32_t delay);
+
+		void readHeader();
+		void onReadHeader(const boost::system::error_code& error);
+		void onReadBody(const boost::system::error_code& error);
+
+		void parseChallenge();
+		void parseGamePacket();
+		void sendLogin(uint32_t timestamp, uint8_t randomNumber);
+
+		void sendPacket(NetworkMessage& msg);
+		void write(const uint8_t* data, size_t size);
+		void onWrite(const boost::system::error_code& error);
+
+		void scheduleTick();
+		void onTick(const boost::system::error_code& error);
+		void walk();
+		void attack();
+		void castSpell();
+		void sendProbe();
+		void say(const std::string& text);
+
+		void setOffline();
+		void closeSocket();
+
+		boost::asio::ip::tcp::socket socket;
+		boost::asio::steady_timer timer;
+
+		const LoadgenOptions& options;
+		const RSA& rsa;
+		LoadStats& stats;
+		std::vector<std::atomic<uint32_t>>& playerIds;
+
+		std::mt19937 generator;
+		xtea::key key;
+
+		NetworkMessage input;
+		std::deque<std::vector<uint8_t>> outputQueue;
+
+		std::string characterName;
+		std::string probeText;
+		std::chrono::steady_clock::time_point probeSent;
+		std::chrono::steady_clock::time_point nextProbe;
+		std::chrono::steady_clock::time_point nextPong;
+
+		const uint32_t index;
+		uint32_t playerId = 0;
+		uint32_t attackTarget = 0;
+		uint32_t probeSequence = 0;
+		uint32_t walkStep = 0;
+
+		State state = STATE_CONNECTING;
+		bool probePending = false;
+};
+
+#endif
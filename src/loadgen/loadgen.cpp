@@ -0,0 +1,374 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "botclient.h"
+#include "rsa.h"
+
+namespace {
+
+using Histogram = std::vector<std::pair<double, uint64_t>>;
+
+bool parseArgument(const std::string& arg, LoadgenOptions& options, bool& printSql)
+{
+	if (arg == "--print-sql") {
+		printSql = true;
+		return true;
+	}
+
+	auto separator = arg.find('=');
+	if (arg.compare(0, 2, "--") != 0 || separator == std::string::npos) {
+		return false;
+	}
+
+	const std::string name = arg.substr(2, separator - 2);
+	const std::string value = arg.substr(separator + 1);
+	try {
+		if (name == "host") {
+			options.host = value;
+		} else if (name == "port") {
+			options.gamePort = static_cast<uint16_t>(std::stoul(value));
+		} else if (name == "metrics-port") {
+			options.metricsPort = static_cast<uint16_t>(std::stoul(value));
+		} else if (name == "key") {
+			options.keyFile = value;
+		} else if (name == "bots") {
+			options.bots = std::stoul(value);
+		} else if (name == "first") {
+			options.firstBot = std::stoul(value);
+		} else if (name == "account-prefix") {
+			options.accountPrefix = value;
+		} else if (name == "password") {
+			options.password = value;
+		} else if (name == "character-prefix") {
+			options.characterPrefix = value;
+		} else if (name == "threads") {
+			options.threads = std::max<uint32_t>(1, std::stoul(value));
+		} else if (name == "duration") {
+			options.duration = std::stoul(value);
+		} else if (name == "logins-per-second") {
+			options.loginsPerSecond = std::max<uint32_t>(1, std::stoul(value));
+		} else if (name == "report-interval") {
+			options.reportInterval = std::max<uint32_t>(1, std::stoul(value));
+		} else if (name == "action-interval") {
+			options.actionInterval = std::max<uint32_t>(1, std::stoul(value));
+		} else if (name == "walk") {
+			options.walkWeight = std::stoul(value);
+		} else if (name == "attack") {
+			options.attackWeight = std::stoul(value);
+		} else if (name == "spell") {
+			options.spellWeight = std::stoul(value);
+		} else if (name == "walk-square") {
+			options.walkSquare = std::stoul(value);
+		} else if (name == "spells") {
+			options.spellWords.clear();
+			std::istringstream ss(value);
+			for (std::string words; std::getline(ss, words, ',');) {
+				options.spellWords.push_back(words);
+			}
+		} else if (name == "probe-interval") {
+			options.probeInterval = std::stoul(value);
+		} else {
+			return false;
+		}
+	} catch (const std::exception&) {
+		return false;
+	}
+	return true;
+}
+
+void printUsage()
+{
+	std::cout << "Usage: tfs_loadgen [--option=value...] [--print-sql]\n"
+	          << "  --host, --port              game server address (127.0.0.1:7172)\n"
+	          << "  --key                       server RSA key (key.pem)\n"
+	          << "  --bots, --first             number of bots and index of the first one (10, 1)\n"
+	          << "  --account-prefix, --password, --character-prefix\n"
+	          << "                              bot n logs in as <account-prefix>n / <character-prefix>n\n"
+	          << "  --duration                  seconds to run once every bot is started (60)\n"
+	          << "  --logins-per-second         login ramp (10)\n"
+	          << "  --threads                   client network threads (1)\n"
+	          << "  --action-interval           milliseconds between bot actions (500)\n"
+	          << "  --walk, --attack, --spell   action weights (60, 10, 10)\n"
+	          << "  --walk-square               side of the square the bots patrol (3)\n"
+	          << "  --spells                    comma separated spell words (exura)\n"
+	          << "  --probe-interval            milliseconds between chat round trip probes (2000)\n"
+	          << "  --metrics-port              server metrics port for tick latency, 0 to skip (0)\n"
+	          << "  --report-interval           seconds between reports (10)\n"
+	          << "  --print-sql                 print the statements creating the bot accounts and exit\n";
+}
+
+void printSetupSql(const LoadgenOptions& options)
+{
+	for (uint32_t i = 0; i < options.bots; ++i) {
+		const uint32_t bot = options.firstBot + i;
+		const std::string account = options.accountPrefix + std::to_string(bot);
+		std::cout << "INSERT INTO `accounts` (`name`, `password`) VALUES ('" << account << "', SHA1('" << options.password << "'));\n";
+		std::cout << "INSERT INTO `players` (`name`, `account_id`, `conditions`) SELECT '" << options.characterPrefix << bot << "', `id`, '' FROM `accounts` WHERE `name` = '" << account << "';\n";
+	}
+}
+
+uint32_t percentile(const std::vector<uint32_t>& sorted, double fraction)
+{
+	if (sorted.empty()) {
+		return 0;
+	}
+	return sorted[std::min<size_t>(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()))];
+}
+
+// fetches the metrics text and keeps the cumulative buckets of every histogram
+bool scrapeHistograms(const LoadgenOptions& options, std::map<std::string, Histogram>& histograms)
+{
+	try {
+		boost::asio::io_service io_service;
+		boost::asio::ip::tcp::socket socket(io_service);
+		socket.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address::from_string(options.host), options.metricsPort));
+
+		const std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+		boost::asio::write(socket, boost::asio::buffer(request));
+
+		std::string response;
+		boost::system::error_code error;
+		char buffer[4096];
+		size_t length;
+		while ((length = socket.read_some(boost::asio::buffer(buffer), error)) > 0) {
+			response.append(buffer, length);
+		}
+
+		// a truncated or empty body means the server failed to write the whole render
+		const auto headerEnd = response.find("\r\n\r\n");
+		const auto lengthHeader = response.find("Content-Length: ");
+		if (headerEnd == std::string::npos || lengthHeader == std::string::npos || lengthHeader > headerEnd) {
+			std::cout << "[Warning - scrapeHistograms] Malformed metrics response." << std::endl;
+			return false;
+		}
+
+		const size_t contentLength = std::stoul(response.substr(lengthHeader + 16));
+		const size_t bodyLength = response.size() - headerEnd - 4;
+		if (contentLength == 0 || bodyLength != contentLength) {
+			std::cout << "[Warning - scrapeHistograms] Received " << bodyLength << " of " << contentLength << " metrics bytes." << std::endl;
+			return false;
+		}
+
+		std::istringstream ss(response.substr(headerEnd + 4));
+		std::string line;
+		while (std::getline(ss, line)) {
+			auto bucket = line.find("_bucket{le=\"");
+			if (bucket == std::string::npos) {
+				continue;
+			}
+
+			auto boundEnd = line.find('"', bucket + 12);
+			auto valueStart = line.find(' ', boundEnd);
+			if (boundEnd == std::string::npos || valueStart == std::string::npos) {
+				continue;
+			}
+
+			const std::string bound = line.substr(bucket + 12, boundEnd - bucket - 12);
+			double upperBound = bound == "+Inf" ? std::numeric_limits<double>::infinity() : std::stod(bound);
+			histograms[line.substr(0, bucket)].emplace_back(upperBound, std::stoull(line.substr(valueStart + 1)));
+		}
+	} catch (const std::exception& e) {
+		std::cout << "[Warning - scrapeHistograms] " << e.what() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// bucket bound the given fraction of the observations between both scrapes fall under
+double histogramQuantile(const Histogram& before, const Histogram& after, double fraction)
+{
+	uint64_t total = after.back().second - (before.size() == after.size() ? before.back().second : 0);
+	if (total == 0) {
+		return 0;
+	}
+
+	for (size_t i = 0; i < after.size(); ++i) {
+		uint64_t count = after[i].second - (before.size() == after.size() ? before[i].second : 0);
+		if (count >= fraction * total) {
+			return after[i].first;
+		}
+	}
+	return after.back().first;
+}
+
+void printServerLatency(const std::map<std::string, Histogram>& before, const std::map<std::string, Histogram>& after)
+{
+	static const std::pair<const char*, const char*> histograms[] = {
+		{"tfs_check_creatures_seconds", "creature tick"},
+		{"tfs_dispatcher_task_wait_seconds", "dispatcher wait"},
+	};
+
+	for (const auto& it : histograms) {
+		auto afterIt = after.find(it.first);
+		if (afterIt == after.end() || afterIt->second.empty()) {
+			continue;
+		}
+
+		auto beforeIt = before.find(it.first);
+		const Histogram& beforeHistogram = beforeIt != before.end() ? beforeIt->second : Histogram();
+		std::cout << "  server " << it.second << " <= p50 " << histogramQuantile(beforeHistogram, afterIt->second, 0.5) * 1000
+		          << " ms, p95 " << histogramQuantile(beforeHistogram, afterIt->second, 0.95) * 1000
+		          << " ms, p99 " << histogramQuantile(beforeHistogram, afterIt->second, 0.99) * 1000 << " ms" << std::endl;
+	}
+}
+
+void printReport(LoadStats& stats, std::vector<uint32_t>& roundTrips, double seconds, uint64_t bytesSent, uint64_t bytesReceived)
+{
+	std::sort(roundTrips.begin(), roundTrips.end());
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "> " << stats.online << " online, " << stats.logins << " logins, " << stats.loginFailures << " failed, "
+	          << stats.disconnects << " disconnects, " << stats.lostProbes << " lost probes" << std::endl;
+	std::cout << "  round trip (" << roundTrips.size() << " probes) p50 " << percentile(roundTrips, 0.5) / 1000.0
+	          << " ms, p90 " << percentile(roundTrips, 0.9) / 1000.0
+	          << " ms, p99 " << percentile(roundTrips, 0.99) / 1000.0
+	          << " ms, max " << (roundTrips.empty() ? 0 : roundTrips.back()) / 1000.0 << " ms" << std::endl;
+	std::cout << "  bandwidth in " << bytesReceived / seconds / 1024 << " KiB/s, out " << bytesSent / seconds / 1024 << " KiB/s" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	LoadgenOptions options;
+	bool printSql = false;
+	for (int i = 1; i < argc; ++i) {
+		if (!parseArgument(argv[i], options, printSql)) {
+			std::cout << "Unknown or invalid argument " << argv[i] << '.' << std::endl;
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (printSql) {
+		printSetupSql(options);
+		return 0;
+	}
+
+	RSA rsa;
+	try {
+		rsa.loadPEM(options.keyFile);
+	} catch (const std::exception& e) {
+		std::cout << "> ERROR: " << e.what() << std::endl;
+		return 1;
+	}
+
+	LoadStats stats;
+	std::vector<std::atomic<uint32_t>> playerIds(options.bots);
+
+	// every thread owns an io_service, a bot never leaves the thread it was created on
+	std::vector<std::unique_ptr<boost::asio::io_service>> services;
+	std::vector<std::unique_ptr<boost::asio::io_service::work>> works;
+	std::vector<std::thread> threads;
+	for (uint32_t i = 0; i < options.threads; ++i) {
+		services.emplace_back(new boost::asio::io_service);
+		works.emplace_back(new boost::asio::io_service::work(*services.back()));
+	}
+	for (auto& service : services) {
+		threads.emplace_back([&service]() { service->run(); });
+	}
+
+	std::map<std::string, Histogram> histogramsBefore;
+	std::map<std::string, Histogram> histogramsReport;
+	if (options.metricsPort != 0) {
+		scrapeHistograms(options, histogramsBefore);
+		histogramsReport = histogramsBefore;
+	}
+
+	std::cout << ">> Starting " << options.bots << " bots against " << options.host << ':' << options.gamePort << std::endl;
+
+	std::vector<std::shared_ptr<BotClient>> bots;
+	for (uint32_t i = 0; i < options.bots; ++i) {
+		auto& service = *services[i % services.size()];
+		auto bot = std::make_shared<BotClient>(service, options, rsa, stats, playerIds, i);
+		bots.push_back(bot);
+		service.post([bot]() { bot->start(); });
+
+		if ((i + 1) % options.loginsPerSecond == 0) {
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+		}
+	}
+
+	// the measured run starts once every bot had its chance to log in
+	stats.takeRoundTrips();
+	std::vector<uint32_t> allRoundTrips;
+	const uint64_t startSent = stats.bytesSent;
+	const uint64_t startReceived = stats.bytesReceived;
+	uint64_t reportSent = startSent;
+	uint64_t reportReceived = startReceived;
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto end = start + std::chrono::seconds(options.duration);
+	auto nextReport = start + std::chrono::seconds(options.reportInterval);
+	while (std::chrono::steady_clock::now() < end) {
+		std::this_thread::sleep_until(std::min(end, nextReport));
+		if (std::chrono::steady_clock::now() < nextReport) {
+			break;
+		}
+
+		std::vector<uint32_t> roundTrips = stats.takeRoundTrips();
+		allRoundTrips.insert(allRoundTrips.end(), roundTrips.begin(), roundTrips.end());
+
+		const uint64_t sent = stats.bytesSent;
+		const uint64_t received = stats.bytesReceived;
+		printReport(stats, roundTrips, options.reportInterval, sent - reportSent, received - reportReceived);
+		reportSent = sent;
+		reportReceived = received;
+
+		if (options.metricsPort != 0) {
+			std::map<std::string, Histogram> histograms;
+			if (scrapeHistograms(options, histograms)) {
+				printServerLatency(histogramsReport, histograms);
+				histogramsReport = std::move(histograms);
+			}
+		}
+		nextReport += std::chrono::seconds(options.reportInterval);
+	}
+
+	std::vector<uint32_t> roundTrips = stats.takeRoundTrips();
+	allRoundTrips.insert(allRoundTrips.end(), roundTrips.begin(), roundTrips.end());
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << ">> Summary over " << std::setprecision(1) << std::fixed << elapsed << " seconds" << std::endl;
+	printReport(stats, allRoundTrips, std::max(elapsed, 1.0), stats.bytesSent - startSent, stats.bytesReceived - startReceived);
+	if (options.metricsPort != 0) {
+		std::map<std::string, Histogram> histograms;
+		if (scrapeHistograms(options, histograms)) {
+			printServerLatency(histogramsBefore, histograms);
+		}
+	}
+
+	for (size_t i = 0; i < bots.size(); ++i) {
+		auto bot = bots[i];
+		services[i % services.size()]->post([bot]() { bot->stop(); });
+	}
+
+	// leave the logouts some time to reach the server
+	works.clear();
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+	for (auto& service : services) {
+		service->stop();
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	return 0;
+}
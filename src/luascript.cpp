@@ -42,6 +42,7 @@
 #include "globalevent.h"
 #include "script.h"
 #include "weapons.h"
+#include "tracing.h"
 
 extern Chat* g_chat;
 extern Game g_game;
@@ -542,6 +543,11 @@ int LuaScriptInterface::luaErrorHandler(lua_State* L)
 
 bool LuaScriptInterface::callFunction(int params)
 {
+	TraceSpan span("lua");
+	if (span.isActive()) {
+		span.setDetail(getTraceDetail());
+	}
+
 	bool result = false;
 	int size = lua_gettop(luaState);
 	if (protectedCall(luaState, params, 1) != 0) {
@@ -561,6 +567,11 @@ bool LuaScriptInterface::callFunction(int params)
 
 void LuaScriptInterface::callVoidFunction(int params)
 {
+	TraceSpan span("lua");
+	if (span.isActive()) {
+		span.setDetail(getTraceDetail());
+	}
+
 	int size = lua_gettop(luaState);
 	if (protectedCall(luaState, params, 0) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(luaState));
@@ -573,6 +584,16 @@ void LuaScriptInterface::callVoidFunction(int params)
 	resetScriptEnv();
 }
 
+std::string LuaScriptInterface::getTraceDetail()
+{
+	ScriptEnvironment* env = getScriptEnv();
+	LuaScriptInterface* scriptInterface = env->getScriptInterface();
+	if (!scriptInterface) {
+		return interfaceName;
+	}
+	return scriptInterface->getInterfaceName() + ": " + scriptInterface->getFileById(env->getScriptId());
+}
+
 void LuaScriptInterface::pushVariant(lua_State* L, const LuaVariant& var)
 {
 	lua_createtable(L, 0, 2);
@@ -2117,6 +2138,8 @@ void LuaScriptInterface::registerFunctions()
 	registerMethod("Game", "getMonsterCount", LuaScriptInterface::luaGameGetMonsterCount);
 	registerMethod("Game", "getPlayerCount", LuaScriptInterface::luaGameGetPlayerCount);
 	registerMethod("Game", "getNpcCount", LuaScriptInterface::luaGameGetNpcCount);
+	registerMethod("Game", "getActiveCreatureCount", LuaScriptInterface::luaGameGetActiveCreatureCount);
+	registerMethod("Game", "getIdleMonsterCount", LuaScriptInterface::luaGameGetIdleMonsterCount);
 	registerMethod("Game", "getMonsterTypes", LuaScriptInterface::luaGameGetMonsterTypes);
 
 	registerMethod("Game", "getTowns", LuaScriptInterface::luaGameGetTowns);
@@ -2142,6 +2165,8 @@ void LuaScriptInterface::registerFunctions()
 	registerMethod("Game", "getClientVersion", LuaScriptInterface::luaGameGetClientVersion);
 
 	registerMethod("Game", "reload", LuaScriptInterface::luaGameReload);
+	registerMethod("Game", "startTrace", LuaScriptInterface::luaGameStartTrace);
+	registerMethod("Game", "getRandomValues", LuaScriptInterface::luaGameGetRandomValues);
 
 	// Variant
 	registerClass("Variant", "", LuaScriptInterface::luaVariantCreate);
@@ -4394,6 +4419,20 @@ int LuaScriptInterface::luaGameGetNpcCount(lua_State* L)
 	return 1;
 }
 
+int LuaScriptInterface::luaGameGetActiveCreatureCount(lua_State* L)
+{
+	// Game.getActiveCreatureCount()
+	lua_pushnumber(L, g_game.getActiveCreatureCount());
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetIdleMonsterCount(lua_State* L)
+{
+	// Game.getIdleMonsterCount()
+	lua_pushnumber(L, g_game.getIdleMonsterCount());
+	return 1;
+}
+
 int LuaScriptInterface::luaGameGetMonsterTypes(lua_State* L)
 {
 	// Game.getMonsterTypes()
@@ -4729,6 +4768,45 @@ int LuaScriptInterface::luaGameReload(lua_State* L)
 	return 1;
 }
 
+int LuaScriptInterface::luaGameStartTrace(lua_State* L)
+{
+	// Game.startTrace(milliseconds)
+	pushBoolean(L, g_tracer.startCapture(getNumber<uint32_t>(L, 1)));
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetRandomValues(lua_State* L)
+{
+	// Game.getRandomValues(count, min, max)
+	static constexpr int32_t MAX_RANDOM_VALUES = 10000;
+
+	int32_t count = getNumber<int32_t>(L, 1);
+	if (count < 0 || count > MAX_RANDOM_VALUES) {
+		reportErrorFunc(L, "Count must be between 0 and " + std::to_string(MAX_RANDOM_VALUES) + ".");
+		lua_pushnil(L);
+		return 1;
+	}
+
+	int32_t minValue = getNumber<int32_t>(L, 2);
+	int32_t maxValue = getNumber<int32_t>(L, 3);
+	if (minValue > maxValue) {
+		reportErrorFunc(L, "Min value is greater than max value.");
+		lua_pushnil(L);
+		return 1;
+	}
+
+	std::vector<int32_t> values(count);
+	uniform_random_fill(values.data(), values.size(), minValue, maxValue);
+
+	lua_createtable(L, values.size(), 0);
+	int index = 0;
+	for (int32_t value : values) {
+		lua_pushnumber(L, value);
+		lua_rawseti(L, -2, ++index);
+	}
+	return 1;
+}
+
 // Variant
 int LuaScriptInterface::luaVariantCreate(lua_State* L)
 {
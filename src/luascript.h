@@ -224,6 +224,10 @@ class LuaScriptInterface
 			return scriptEnv + scriptEnvIndex;
 		}
 
+		static bool isScriptRunning() {
+			return scriptEnvIndex >= 0;
+		}
+
 		static bool reserveScriptEnv() {
 			return ++scriptEnvIndex < 16;
 		}
@@ -436,6 +440,7 @@ class LuaScriptInterface
 		void registerGlobalBoolean(const std::string& name, bool value);
 
 		static std::string getStackTrace(lua_State* L, const std::string& error_desc);
+		std::string getTraceDetail();
 
 		static bool getArea(lua_State* L, std::vector<uint32_t>& vec, uint32_t& rows);
 
@@ -537,6 +542,8 @@ class LuaScriptInterface
 		static int luaGameGetMonsterCount(lua_State* L);
 		static int luaGameGetPlayerCount(lua_State* L);
 		static int luaGameGetNpcCount(lua_State* L);
+		static int luaGameGetActiveCreatureCount(lua_State* L);
+		static int luaGameGetIdleMonsterCount(lua_State* L);
 		static int luaGameGetMonsterTypes(lua_State* L);
 
 		static int luaGameGetTowns(lua_State* L);
@@ -562,6 +569,8 @@ class LuaScriptInterface
 		static int luaGameGetClientVersion(lua_State* L);
 
 		static int luaGameReload(lua_State* L);
+		static int luaGameStartTrace(lua_State* L);
+		static int luaGameGetRandomValues(lua_State* L);
 
 		// Variant
 		static int luaVariantCreate(lua_State* L);
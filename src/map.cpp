@@ -24,7 +24,9 @@
 #include "combat.h"
 #include "creature.h"
 #include "game.h"
+#include "metrics.h"
 #include "monster.h"
+#include "tracing.h"
 
 extern Game g_game;
 
@@ -152,6 +154,8 @@ void Map::setTile(uint16_t x, uint16_t y, uint8_t z, Tile* newTile)
 	} else {
 		tile = newTile;
 	}
+
+	setWalkBits(*floor, offsetX, offsetY, tile);
 }
 
 void Map::removeTile(uint16_t x, uint16_t y, uint8_t z)
@@ -192,10 +196,98 @@ void Map::removeTile(uint16_t x, uint16_t y, uint8_t z)
 		if (ground) {
 			g_game.internalRemoveItem(ground);
 			tile->setGround(nullptr);
+			updateWalkMask(tile);
 		}
 	}
 }
 
+void Map::setWalkBits(Floor& floor, uint32_t offsetX, uint32_t offsetY, const Tile* tile)
+{
+	const uint64_t bit = static_cast<uint64_t>(1) << ((offsetY << 3) | offsetX);
+	floor.walkOpenMask &= ~bit;
+	floor.walkPushMask &= ~bit;
+	floor.walkQueryMask &= ~bit;
+
+	if (!tile || !tile->getGround() || tile->hasFlag(TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT | TILESTATE_PROTECTIONZONE |
+	        TILESTATE_IMMOVABLEBLOCKSOLID | TILESTATE_IMMOVABLENOFIELDBLOCKPATH)) {
+		return;
+	}
+
+	floor.walkOpenMask |= bit;
+	if (tile->hasFlag(TILESTATE_BLOCKSOLID | TILESTATE_NOFIELDBLOCKPATH)) {
+		floor.walkPushMask |= bit;
+	}
+
+	const CreatureVector* creatures = tile->getCreatures();
+	if ((creatures && !creatures->empty()) || tile->hasFlag(TILESTATE_MAGICFIELD)) {
+		floor.walkQueryMask |= bit;
+	}
+}
+
+void Map::updateWalkMask(const Tile* tile)
+{
+	const Position& pos = tile->getPosition();
+	if (pos.z >= MAP_MAX_LAYERS) {
+		return;
+	}
+
+	QTreeLeafNode* leaf = getQTNode(pos.x, pos.y);
+	if (!leaf) {
+		return;
+	}
+
+	Floor* floor = leaf->getFloor(pos.z);
+	if (!floor) {
+		return;
+	}
+
+	// tiles still being built by the map loader are not placed yet
+	uint32_t offsetX = pos.x & FLOOR_MASK;
+	uint32_t offsetY = pos.y & FLOOR_MASK;
+	if (floor->tiles[offsetX][offsetY] == tile) {
+		setWalkBits(*floor, offsetX, offsetY, tile);
+	}
+}
+
+uint32_t Map::getWalkableRow(const Creature& creature, bool canPushItems, int32_t startX, int32_t y, uint8_t z, int32_t width) const
+{
+	uint32_t row = 0;
+	if (y < 0 || y > 0xFFFF || z >= MAP_MAX_LAYERS) {
+		return row;
+	}
+
+	const int32_t endX = std::min<int32_t>(startX + width, 0x10000);
+	const uint32_t rowShift = (y & FLOOR_MASK) << 3;
+	for (int32_t x = std::max<int32_t>(startX, 0); x < endX;) {
+		const int32_t count = std::min<int32_t>(FLOOR_SIZE - (x & FLOOR_MASK), endX - x);
+		const QTreeLeafNode* leaf = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, x, y);
+		const Floor* floor = leaf ? leaf->getFloor(z) : nullptr;
+		if (floor) {
+			uint32_t open = (floor->walkOpenMask >> rowShift) & 0xFF;
+			uint32_t push = canPushItems ? 0 : ((floor->walkPushMask >> rowShift) & 0xFF);
+			uint32_t query = (floor->walkQueryMask >> rowShift) & 0xFF;
+
+			uint32_t walkable = open & ~push & ~query;
+			for (uint32_t pending = open & query; pending != 0; pending &= pending - 1) {
+				uint32_t offsetX = 0;
+				while (!(pending & (1 << offsetX))) {
+					++offsetX;
+				}
+
+				const Tile* tile = floor->tiles[offsetX][y & FLOOR_MASK];
+				if (tile->queryAdd(0, creature, 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) == RETURNVALUE_NOERROR) {
+					walkable |= 1 << offsetX;
+				}
+			}
+
+			walkable = (walkable >> (x & FLOOR_MASK)) & ((1 << count) - 1);
+			row |= walkable << (x - startX);
+		}
+		x += count;
+	}
+	return row;
+}
+
 bool Map::placeCreature(const Position& centerPos, Creature* creature, bool extendedPos/* = false*/, bool forceLogin/* = false*/)
 {
 	bool foundTile;
@@ -265,6 +357,9 @@ bool Map::placeCreature(const Position& centerPos, Creature* creature, bool exte
 
 	const Position& dest = toCylinder->getPosition();
 	getQTNode(dest.x, dest.y)->addCreature(creature);
+	if (creature->getPlayer()) {
+		addPlayerPresence(dest);
+	}
 	return true;
 }
 
@@ -277,18 +372,16 @@ void Map::moveCreature(Creature& creature, Tile& newTile, bool forceTeleport/* =
 
 	bool teleport = forceTeleport || !newTile.getGround() || !Position::areInRange<1, 1, 0>(oldPos, newPos);
 
-	SpectatorVec spectators, newPosSpectators;
-	getSpectators(spectators, oldPos, true);
-	getSpectators(newPosSpectators, newPos, true);
-	spectators.addSpectators(newPosSpectators);
+	SpectatorVec spectators;
+	getMoveSpectators(spectators, oldPos, newPos);
 
-	std::vector<int32_t> oldStackPosVector;
+	// players that see the creature, with its stack position on the old tile
+	std::vector<std::pair<Player*, int32_t>> viewers;
+	viewers.reserve(spectators.size());
 	for (Creature* spectator : spectators) {
 		if (Player* tmpPlayer = spectator->getPlayer()) {
 			if (tmpPlayer->canSeeCreature(&creature)) {
-				oldStackPosVector.push_back(oldTile.getClientIndexOfCreature(tmpPlayer, &creature));
-			} else {
-				oldStackPosVector.push_back(-1);
+				viewers.emplace_back(tmpPlayer, oldTile.getClientIndexOfCreature(tmpPlayer, &creature));
 			}
 		}
 	}
@@ -305,6 +398,11 @@ void Map::moveCreature(Creature& creature, Tile& newTile, bool forceTeleport/* =
 		new_leaf->addCreature(&creature);
 	}
 
+	if (creature.getPlayer()) {
+		removePlayerPresence(oldPos);
+		addPlayerPresence(newPos);
+	}
+
 	//add the creature
 	newTile.addThing(&creature);
 
@@ -323,15 +421,10 @@ void Map::moveCreature(Creature& creature, Tile& newTile, bool forceTeleport/* =
 	}
 
 	//send to client
-	size_t i = 0;
-	for (Creature* spectator : spectators) {
-		if (Player* tmpPlayer = spectator->getPlayer()) {
-			//Use the correct stackpos
-			int32_t stackpos = oldStackPosVector[i++];
-			if (stackpos != -1) {
-				tmpPlayer->sendCreatureMove(&creature, newPos, newTile.getClientIndexOfCreature(tmpPlayer, &creature), oldPos, stackpos, teleport);
-			}
-		}
+	for (const auto& viewer : viewers) {
+		//Use the correct stackpos
+		Player* tmpPlayer = viewer.first;
+		tmpPlayer->sendCreatureMove(&creature, newPos, newTile.getClientIndexOfCreature(tmpPlayer, &creature), oldPos, viewer.second, teleport);
 	}
 
 	//event method
@@ -408,6 +501,8 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, boo
 	bool foundCache = false;
 	bool cacheResult = false;
 
+	g_metrics.spectatorQueries.add();
+
 	minRangeX = (minRangeX == 0 ? -maxViewportX : -minRangeX);
 	maxRangeX = (maxRangeX == 0 ? maxViewportX : maxRangeX);
 	minRangeY = (minRangeY == 0 ? -maxViewportY : -minRangeY);
@@ -424,6 +519,7 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, boo
 				}
 
 				foundCache = true;
+				g_metrics.spectatorCacheHits.add();
 			}
 		}
 
@@ -447,6 +543,7 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, boo
 				}
 
 				foundCache = true;
+				g_metrics.spectatorCacheHits.add();
 			} else {
 				cacheResult = true;
 			}
@@ -458,20 +555,7 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, boo
 		int32_t maxRangeZ;
 
 		if (multifloor) {
-			if (centerPos.z > 7) {
-				//underground (8->15)
-				minRangeZ = std::max<int32_t>(centerPos.getZ() - 2, 0);
-				maxRangeZ = std::min<int32_t>(centerPos.getZ() + 2, MAP_MAX_LAYERS - 1);
-			} else if (centerPos.z == 6) {
-				minRangeZ = 0;
-				maxRangeZ = 8;
-			} else if (centerPos.z == 7) {
-				minRangeZ = 0;
-				maxRangeZ = 9;
-			} else {
-				minRangeZ = 0;
-				maxRangeZ = 7;
-			}
+			getMultiFloorRange(centerPos, minRangeZ, maxRangeZ);
 		} else {
 			minRangeZ = centerPos.z;
 			maxRangeZ = centerPos.z;
@@ -489,6 +573,123 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, boo
 	}
 }
 
+void Map::getMultiFloorRange(const Position& centerPos, int32_t& minRangeZ, int32_t& maxRangeZ)
+{
+	if (centerPos.z > 7) {
+		//underground (8->15)
+		minRangeZ = std::max<int32_t>(centerPos.getZ() - 2, 0);
+		maxRangeZ = std::min<int32_t>(centerPos.getZ() + 2, MAP_MAX_LAYERS - 1);
+	} else if (centerPos.z == 6) {
+		minRangeZ = 0;
+		maxRangeZ = 8;
+	} else if (centerPos.z == 7) {
+		minRangeZ = 0;
+		maxRangeZ = 9;
+	} else {
+		minRangeZ = 0;
+		maxRangeZ = 7;
+	}
+}
+
+bool Map::isInViewport(const Position& centerPos, const Position& pos, bool multifloor)
+{
+	int32_t minRangeZ, maxRangeZ;
+	if (multifloor) {
+		getMultiFloorRange(centerPos, minRangeZ, maxRangeZ);
+	} else {
+		minRangeZ = centerPos.z;
+		maxRangeZ = centerPos.z;
+	}
+
+	if (pos.z < minRangeZ || pos.z > maxRangeZ) {
+		return false;
+	}
+
+	int32_t offsetZ = Position::getOffsetZ(centerPos, pos);
+	return std::abs(pos.x - offsetZ - centerPos.x) <= maxViewportX && std::abs(pos.y - offsetZ - centerPos.y) <= maxViewportY;
+}
+
+void Map::getMoveSpectators(SpectatorVec& spectators, const Position& oldPos, const Position& newPos)
+{
+	if (!Position::areInRange<1, 1, 0>(oldPos, newPos) || oldPos.z >= MAP_MAX_LAYERS) {
+		getSpectators(spectators, oldPos, true);
+
+		SpectatorVec newPosSpectators;
+		getSpectators(newPosSpectators, newPos, true);
+		spectators.addSpectators(newPosSpectators);
+		return;
+	}
+
+	// a single step on the same floor, both viewports fit in one box grown by the step
+	int32_t dx = Position::getOffsetX(newPos, oldPos);
+	int32_t dy = Position::getOffsetY(newPos, oldPos);
+
+	int32_t minRangeZ, maxRangeZ;
+	getMultiFloorRange(oldPos, minRangeZ, maxRangeZ);
+
+	if (dx == 0 || dy == 0) {
+		getSpectatorsInternal(spectators, oldPos, -maxViewportX + std::min<int32_t>(dx, 0), maxViewportX + std::max<int32_t>(dx, 0),
+		                      -maxViewportY + std::min<int32_t>(dy, 0), maxViewportY + std::max<int32_t>(dy, 0), minRangeZ, maxRangeZ, false);
+		return;
+	}
+
+	// diagonal steps leave two corners of the box outside of both viewports
+	SpectatorVec boxSpectators;
+	getSpectatorsInternal(boxSpectators, oldPos, -maxViewportX + std::min<int32_t>(dx, 0), maxViewportX + std::max<int32_t>(dx, 0),
+	                      -maxViewportY + std::min<int32_t>(dy, 0), maxViewportY + std::max<int32_t>(dy, 0), minRangeZ, maxRangeZ, false);
+
+	for (Creature* spectator : boxSpectators) {
+		const Position& cpos = spectator->getPosition();
+		int32_t offsetZ = Position::getOffsetZ(oldPos, cpos);
+		int32_t offsetX = cpos.x - offsetZ - oldPos.x;
+		int32_t offsetY = cpos.y - offsetZ - oldPos.y;
+
+		bool inOldRange = std::abs(offsetX) <= maxViewportX && std::abs(offsetY) <= maxViewportY;
+		bool inNewRange = std::abs(offsetX - dx) <= maxViewportX && std::abs(offsetY - dy) <= maxViewportY;
+		if (inOldRange || inNewRange) {
+			spectators.emplace_back(spectator);
+		}
+	}
+}
+
+static uint32_t getPlayerCell(int32_t cellX, int32_t cellY, int32_t z)
+{
+	return (static_cast<uint32_t>(z) << 24) | (static_cast<uint32_t>(cellX) << 12) | static_cast<uint32_t>(cellY);
+}
+
+bool Map::hasPlayersAround(const Position& pos) const
+{
+	if (playerCells.empty()) {
+		return false;
+	}
+
+	int32_t startX = std::max<int32_t>(pos.x - maxViewportX, 0);
+	int32_t startY = std::max<int32_t>(pos.y - maxViewportY, 0);
+	int32_t endX = std::min<int32_t>(pos.x + maxViewportX, 0xFFFF);
+	int32_t endY = std::min<int32_t>(pos.y + maxViewportY, 0xFFFF);
+	for (int32_t cellY = startY >> PLAYER_CELL_BITS; cellY <= (endY >> PLAYER_CELL_BITS); ++cellY) {
+		for (int32_t cellX = startX >> PLAYER_CELL_BITS; cellX <= (endX >> PLAYER_CELL_BITS); ++cellX) {
+			if (playerCells.find(getPlayerCell(cellX, cellY, pos.z)) != playerCells.end()) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void Map::addPlayerPresence(const Position& pos)
+{
+	++playerCells[getPlayerCell(pos.x >> PLAYER_CELL_BITS, pos.y >> PLAYER_CELL_BITS, pos.z)];
+}
+
+void Map::removePlayerPresence(const Position& pos)
+{
+	auto it = playerCells.find(getPlayerCell(pos.x >> PLAYER_CELL_BITS, pos.y >> PLAYER_CELL_BITS, pos.z));
+	if (it != playerCells.end() && --it->second == 0) {
+		playerCells.erase(it);
+	}
+}
+
 void Map::clearSpectatorCache()
 {
 	spectatorCache.clear();
@@ -631,6 +832,12 @@ bool Map::getPathMatching(const Creature& creature, std::vector<Direction>& dirL
 
 	const Position startPos = pos;
 
+	g_metrics.pathSearches.add();
+	MetricTimer timer(g_metrics.pathSearch);
+	// searches run on every worker thread, the shared counter is only touched once per search
+	MetricTally nodesExpanded(g_metrics.pathNodesExpanded);
+	TraceSpan span("getPathMatching");
+
 	AStarNode* found = nullptr;
 	while (fpp.maxSearchDist != 0 || nodes.getClosedNodes() < 100) {
 		AStarNode* n = nodes.getBestNode();
@@ -641,6 +848,8 @@ bool Map::getPathMatching(const Creature& creature, std::vector<Direction>& dirL
 			return false;
 		}
 
+		nodesExpanded.add();
+
 		const int_fast32_t x = n->x;
 		const int_fast32_t y = n->y;
 		pos.x = x;
@@ -79,6 +79,9 @@ static constexpr int32_t FLOOR_BITS = 3;
 static constexpr int32_t FLOOR_SIZE = (1 << FLOOR_BITS);
 static constexpr int32_t FLOOR_MASK = (FLOOR_SIZE - 1);
 
+static constexpr int32_t PLAYER_CELL_BITS = 4;
+static constexpr int32_t PLAYER_CELL_SIZE = (1 << PLAYER_CELL_BITS);
+
 struct Floor {
 	constexpr Floor() = default;
 	~Floor();
@@ -88,6 +91,13 @@ struct Floor {
 	Floor& operator=(const Floor&) = delete;
 
 	Tile* tiles[FLOOR_SIZE][FLOOR_SIZE] = {};
+
+	// Monster path finding state, one bit per tile at (y << 3) | x: tiles with ground
+	// and no fixed obstacle, tiles blocked by items that can be pushed away, and tiles
+	// whose creatures or magic field still need a full Tile::queryAdd
+	uint64_t walkOpenMask = 0;
+	uint64_t walkPushMask = 0;
+	uint64_t walkQueryMask = 0;
 };
 
 class FrozenPathingConditionCall;
@@ -149,6 +159,9 @@ class QTreeLeafNode final : public QTreeNode
 		Floor* getFloor(uint8_t z) const {
 			return array[z];
 		}
+		QTreeLeafNode* getSouthLeaf() const {
+			return leafS;
+		}
 
 		void addCreature(Creature* c);
 		void removeCreature(Creature* c);
@@ -232,9 +245,26 @@ class Map
 		                   int32_t minRangeX = 0, int32_t maxRangeX = 0,
 		                   int32_t minRangeY = 0, int32_t maxRangeY = 0);
 
+		// union of the multifloor spectators of both positions, each creature listed once
+		void getMoveSpectators(SpectatorVec& spectators, const Position& oldPos, const Position& newPos);
+
+		// whether a creature at pos is collected by getSpectators around centerPos with the default ranges
+		static bool isInViewport(const Position& centerPos, const Position& pos, bool multifloor);
+
+		// refreshes the walkability bits of a tile after its flags or creatures changed
+		void updateWalkMask(const Tile* tile);
+
+		// walkability of the cells [startX, startX + width) of a row for a monster, bit 0 is startX
+		uint32_t getWalkableRow(const Creature& creature, bool canPushItems, int32_t startX, int32_t y, uint8_t z, int32_t width) const;
+
 		void clearSpectatorCache();
 		void clearPlayersSpectatorCache();
 
+		// whether any player stands in a presence cell overlapping the single floor viewport of pos
+		bool hasPlayersAround(const Position& pos) const;
+		void addPlayerPresence(const Position& pos);
+		void removePlayerPresence(const Position& pos);
+
 		/**
 		  * Checks if you can throw an object to that position
 		  *	\param fromPos from Source point
@@ -277,6 +307,9 @@ class Map
 		SpectatorCache spectatorCache;
 		SpectatorCache playersSpectatorCache;
 
+		// number of players per floor and PLAYER_CELL_SIZE square, keyed by getPlayerCell
+		std::unordered_map<uint32_t, uint32_t> playerCells;
+
 		QTreeNode root;
 
 		std::string spawnfile;
@@ -291,6 +324,10 @@ class Map
 		                           int32_t minRangeY, int32_t maxRangeY,
 		                           int32_t minRangeZ, int32_t maxRangeZ, bool onlyPlayers) const;
 
+		static void setWalkBits(Floor& floor, uint32_t offsetX, uint32_t offsetY, const Tile* tile);
+
+		static void getMultiFloorRange(const Position& centerPos, int32_t& minRangeZ, int32_t& maxRangeZ);
+
 		friend class Game;
 		friend class IOMap;
 };
@@ -0,0 +1,108 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "metrics.h"
+
+namespace {
+
+void writeHeader(std::ostringstream& ss, const char* name, const char* type, const char* help)
+{
+	ss << "# HELP " << name << ' ' << help << '\n';
+	ss << "# TYPE " << name << ' ' << type << '\n';
+}
+
+void writeCounter(std::ostringstream& ss, const char* name, const char* help, const MetricCounter& counter)
+{
+	writeHeader(ss, name, "counter", help);
+	ss << name << ' ' << counter.get() << '\n';
+}
+
+void writeGauge(std::ostringstream& ss, const char* name, const char* help, const MetricGauge& gauge)
+{
+	writeHeader(ss, name, "gauge", help);
+	ss << name << ' ' << gauge.get() << '\n';
+}
+
+void writeHistogram(std::ostringstream& ss, const char* name, const char* help, const MetricHistogram& histogram)
+{
+	writeHeader(ss, name, "histogram", help);
+
+	uint64_t count = 0;
+	for (size_t i = 0; i < MetricHistogram::bounds.size(); ++i) {
+		count += histogram.getBucket(i);
+		ss << name << "_bucket{le=\"" << (MetricHistogram::bounds[i] / 1e6) << "\"} " << count << '\n';
+	}
+	count += histogram.getBucket(MetricHistogram::bounds.size());
+	ss << name << "_bucket{le=\"+Inf\"} " << count << '\n';
+	ss << name << "_sum " << (histogram.getSum() / 1e6) << '\n';
+	ss << name << "_count " << count << '\n';
+}
+
+}
+
+ProtocolTraffic& Metrics::getProtocolTraffic(const std::string& protocolName)
+{
+	std::lock_guard<std::mutex> lockClass(trafficLock);
+
+	auto& protocolTraffic = traffic[protocolName];
+	if (!protocolTraffic) {
+		protocolTraffic.reset(new ProtocolTraffic);
+	}
+	return *protocolTraffic;
+}
+
+std::string Metrics::render() const
+{
+	std::ostringstream ss;
+	ss.precision(9);
+
+	writeHistogram(ss, "tfs_dispatcher_task_wait_seconds", "Time tasks spent queued before the dispatcher ran them.", dispatcherTaskWait);
+	writeHistogram(ss, "tfs_dispatcher_task_run_seconds", "Time the dispatcher spent running a task.", dispatcherTaskRun);
+	writeGauge(ss, "tfs_dispatcher_queue_depth", "Tasks taken by the dispatcher in its last batch.", dispatcherQueueDepth);
+	writeHistogram(ss, "tfs_check_creatures_seconds", "Time spent in one creature think tick.", checkCreaturesTick);
+	writeHistogram(ss, "tfs_decay_seconds", "Time spent in one item decay tick.", decayTick);
+	writeHistogram(ss, "tfs_spawn_check_seconds", "Time spent in one batch of spawn checks.", spawnCheck);
+	writeHistogram(ss, "tfs_target_combat_seconds", "Time spent applying combat to a single target.", targetCombat);
+	writeHistogram(ss, "tfs_area_combat_seconds", "Time spent applying combat to an area.", areaCombat);
+	writeCounter(ss, "tfs_spectator_queries_total", "Spectator lookups on the map.", spectatorQueries);
+	writeCounter(ss, "tfs_spectator_cache_hits_total", "Spectator lookups answered from the spectator cache.", spectatorCacheHits);
+	writeCounter(ss, "tfs_path_searches_total", "A* path searches.", pathSearches);
+	writeCounter(ss, "tfs_path_nodes_expanded_total", "Nodes expanded by A* path searches.", pathNodesExpanded);
+	writeHistogram(ss, "tfs_path_search_seconds", "Time spent in one A* path search.", pathSearch);
+	writeHistogram(ss, "tfs_database_query_seconds", "Time spent running database queries, including the wait for the connection.", databaseQuery);
+	writeGauge(ss, "tfs_players_online", "Players in the world.", playersOnline);
+	writeGauge(ss, "tfs_monsters_online", "Monsters in the world.", monstersOnline);
+	writeGauge(ss, "tfs_npcs_online", "Npcs in the world.", npcsOnline);
+	writeGauge(ss, "tfs_active_creatures", "Creatures visited by the think tick.", activeCreatures);
+
+	std::lock_guard<std::mutex> lockClass(trafficLock);
+
+	writeHeader(ss, "tfs_network_received_bytes_total", "counter", "Bytes received per protocol.");
+	for (const auto& it : traffic) {
+		ss << "tfs_network_received_bytes_total{protocol=\"" << it.first << "\"} " << it.second->bytesReceived.get() << '\n';
+	}
+
+	writeHeader(ss, "tfs_network_sent_bytes_total", "counter", "Bytes sent per protocol.");
+	for (const auto& it : traffic) {
+		ss << "tfs_network_sent_bytes_total{protocol=\"" << it.first << "\"} " << it.second->bytesSent.get() << '\n';
+	}
+	return ss.str();
+}
@@ -0,0 +1,179 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_METRICS_H_715463F0E6C643959085BB9C8F53420D
+#define FS_METRICS_H_715463F0E6C643959085BB9C8F53420D
+
+#include <array>
+#include <atomic>
+
+// All recording is done with relaxed atomics, readers only need eventually consistent values
+
+class MetricCounter
+{
+	public:
+		void add(uint64_t value = 1) {
+			this->value.fetch_add(value, std::memory_order_relaxed);
+		}
+
+		uint64_t get() const {
+			return value.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<uint64_t> value{0};
+};
+
+class MetricGauge
+{
+	public:
+		void set(int64_t value) {
+			this->value.store(value, std::memory_order_relaxed);
+		}
+
+		int64_t get() const {
+			return value.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<int64_t> value{0};
+};
+
+// Latency histogram, bucket upper bounds are in microseconds
+class MetricHistogram
+{
+	public:
+		static constexpr std::array<uint64_t, 12> bounds = {{
+			50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000
+		}};
+
+		void observe(uint64_t micros) {
+			size_t index = 0;
+			while (index < bounds.size() && micros > bounds[index]) {
+				++index;
+			}
+			buckets[index].fetch_add(1, std::memory_order_relaxed);
+			sum.fetch_add(micros, std::memory_order_relaxed);
+		}
+
+		// the last bucket holds the observations above every bound
+		uint64_t getBucket(size_t index) const {
+			return buckets[index].load(std::memory_order_relaxed);
+		}
+
+		uint64_t getSum() const {
+			return sum.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::array<std::atomic<uint64_t>, bounds.size() + 1> buckets = {};
+		std::atomic<uint64_t> sum{0};
+};
+
+// Observes the lifetime of the timer into a histogram
+class MetricTimer
+{
+	public:
+		explicit MetricTimer(MetricHistogram& histogram) :
+			histogram(histogram), start(std::chrono::steady_clock::now()) {}
+		~MetricTimer() {
+			histogram.observe(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		// non-copyable
+		MetricTimer(const MetricTimer&) = delete;
+		MetricTimer& operator=(const MetricTimer&) = delete;
+
+	private:
+		MetricHistogram& histogram;
+		std::chrono::steady_clock::time_point start;
+};
+
+// counts locally and adds to the shared counter once when it goes out of scope
+class MetricTally
+{
+	public:
+		explicit MetricTally(MetricCounter& counter) : counter(counter) {}
+		~MetricTally() {
+			if (count != 0) {
+				counter.add(count);
+			}
+		}
+
+		// non-copyable
+		MetricTally(const MetricTally&) = delete;
+		MetricTally& operator=(const MetricTally&) = delete;
+
+		void add() {
+			++count;
+		}
+
+	private:
+		MetricCounter& counter;
+		uint64_t count = 0;
+};
+
+struct ProtocolTraffic
+{
+	MetricCounter bytesReceived;
+	MetricCounter bytesSent;
+};
+
+class Metrics
+{
+	public:
+		// the returned reference stays valid for the lifetime of the server
+		ProtocolTraffic& getProtocolTraffic(const std::string& protocolName);
+
+		// Prometheus text exposition format
+		std::string render() const;
+
+		MetricHistogram dispatcherTaskWait;
+		MetricHistogram dispatcherTaskRun;
+		MetricGauge dispatcherQueueDepth;
+
+		MetricHistogram checkCreaturesTick;
+		MetricHistogram decayTick;
+		MetricHistogram spawnCheck;
+		MetricHistogram targetCombat;
+		MetricHistogram areaCombat;
+
+		MetricCounter spectatorQueries;
+		MetricCounter spectatorCacheHits;
+
+		MetricCounter pathSearches;
+		MetricCounter pathNodesExpanded;
+		MetricHistogram pathSearch;
+
+		MetricHistogram databaseQuery;
+
+		// sampled by the dispatcher right before rendering
+		MetricGauge playersOnline;
+		MetricGauge monstersOnline;
+		MetricGauge npcsOnline;
+		MetricGauge activeCreatures;
+
+	private:
+		mutable std::mutex trafficLock;
+		std::map<std::string, std::unique_ptr<ProtocolTraffic>> traffic;
+};
+
+extern Metrics g_metrics;
+
+#endif
@@ -670,9 +670,9 @@ void Monster::updateIdleStatus()
 {
 	bool idle = false;
 	if (!isSummon() && targetList.empty()) {
-		// check if there are aggressive conditions
+		// aggressive conditions and conditions that still have to run out need the think ticks
 		idle = std::find_if(conditions.begin(), conditions.end(), [](Condition* condition) {
-			return condition->isAggressive();
+			return condition->isAggressive() || condition->getTicks() != -1;
 		}) == conditions.end();
 	}
 
@@ -797,6 +797,7 @@ void Monster::doAttacking(uint32_t interval)
 		}
 
 		if (canUseSpell(myPos, targetPos, spellBlock, interval, inRange, resetTicks)) {
+			// the chance is only rolled for spells that are ready and in range
 			if (spellBlock.chance >= static_cast<uint32_t>(uniform_random(1, 100))) {
 				if (updateLook) {
 					updateLookDirection();
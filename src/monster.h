@@ -22,6 +22,7 @@
 
 #include "tile.h"
 #include "monsters.h"
+#include "objectpool.h"
 
 class Creature;
 class Game;
@@ -47,6 +48,13 @@ class Monster final : public Creature
 		explicit Monster(MonsterType* mType);
 		~Monster();
 
+		static void* operator new(size_t size) {
+			return getMonsterAllocator().allocate(size);
+		}
+		static void operator delete(void* p, size_t size) {
+			getMonsterAllocator().deallocate(p, size);
+		}
+
 		// non-copyable
 		Monster(const Monster&) = delete;
 		Monster& operator=(const Monster&) = delete;
@@ -246,6 +254,9 @@ class Monster final : public Creature
 		bool isIgnoringFieldDamage() const {
 			return ignoreFieldDamage;
 		}
+		bool getIdleStatus() const {
+			return isIdle;
+		}
 
 		BlockType_t blockHit(Creature* attacker, CombatType_t combatType, int32_t& damage,
 		                     bool checkDefense = false, bool checkArmor = false, bool field = false, bool ignoreResistances = false) override;
@@ -301,9 +312,6 @@ class Monster final : public Creature
 
 		void setIdle(bool idle);
 		void updateIdleStatus();
-		bool getIdleStatus() const {
-			return isIdle;
-		}
 
 		void onAddCondition(ConditionType_t type) override;
 		void onEndCondition(ConditionType_t type) override;
@@ -78,6 +78,19 @@ void MoveEvents::clear(bool fromLua)
 	clearMap(uniqueIdMap, fromLua);
 	clearPosMap(positionMap, fromLua);
 
+	std::fill(itemIdEventTypes.begin(), itemIdEventTypes.end(), 0);
+	for (const auto& it : itemIdMap) {
+		if (static_cast<size_t>(it.first) >= itemIdEventTypes.size()) {
+			continue;
+		}
+
+		for (int eventType = MOVE_EVENT_STEP_IN; eventType < MOVE_EVENT_LAST; ++eventType) {
+			if (!it.second.moveEvent[eventType].empty()) {
+				itemIdEventTypes[it.first] |= 1 << eventType;
+			}
+		}
+	}
+
 	reInitState(fromLua);
 }
 
@@ -300,6 +313,10 @@ bool MoveEvents::registerLuaEvent(MoveEvent* event)
 
 void MoveEvents::addEvent(MoveEvent moveEvent, int32_t id, MoveListMap& map)
 {
+	if (&map == &itemIdMap) {
+		indexItemId(id, moveEvent.getEventType());
+	}
+
 	auto it = map.find(id);
 	if (it == map.end()) {
 		MoveEventList moveEventList;
@@ -316,6 +333,46 @@ void MoveEvents::addEvent(MoveEvent moveEvent, int32_t id, MoveListMap& map)
 	}
 }
 
+void MoveEvents::indexItemId(int32_t id, MoveEvent_t eventType)
+{
+	if (id < 0 || id > std::numeric_limits<uint16_t>::max()) {
+		return;
+	}
+
+	if (static_cast<size_t>(id) >= itemIdEventTypes.size()) {
+		itemIdEventTypes.resize(id + 1, 0);
+		indexedItemIds.resize(id + 1, false);
+	}
+
+	itemIdEventTypes[id] |= 1 << eventType;
+
+	if (eventType == MOVE_EVENT_EQUIP || eventType == MOVE_EVENT_DEEQUIP || indexedItemIds[id]) {
+		return;
+	}
+
+	indexedItemIds[id] = true;
+
+	// tiles already holding this item were flagged without it
+	if (g_game.getGameState() != GAME_STATE_STARTUP) {
+		tileFlagsComplete = false;
+	}
+}
+
+bool MoveEvents::isIndexedItem(const Item* item) const
+{
+	if (item->hasAttribute(ITEM_ATTRIBUTE_UNIQUEID) || item->hasAttribute(ITEM_ATTRIBUTE_ACTIONID)) {
+		return true;
+	}
+
+	uint16_t id = item->getID();
+	return id < indexedItemIds.size() && indexedItemIds[id];
+}
+
+bool MoveEvents::hasTileEvents(const Tile* tile) const
+{
+	return !tileFlagsComplete || tile->hasFlag(TILESTATE_MOVEEVENTS);
+}
+
 MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType, slots_t slot)
 {
 	uint32_t slotp;
@@ -333,7 +390,12 @@ MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType, slots_t slot)
 		default: slotp = 0; break;
 	}
 
-	auto it = itemIdMap.find(item->getID());
+	uint16_t id = item->getID();
+	if (id >= itemIdEventTypes.size() || (itemIdEventTypes[id] & (1 << eventType)) == 0) {
+		return nullptr;
+	}
+
+	auto it = itemIdMap.find(id);
 	if (it != itemIdMap.end()) {
 		std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
 		for (MoveEvent& moveEvent : moveEventList) {
@@ -369,7 +431,12 @@ MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType)
 		}
 	}
 
-	it = itemIdMap.find(item->getID());
+	uint16_t id = item->getID();
+	if (id >= itemIdEventTypes.size() || (itemIdEventTypes[id] & (1 << eventType)) == 0) {
+		return nullptr;
+	}
+
+	it = itemIdMap.find(id);
 	if (it != itemIdMap.end()) {
 		std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
 		if (!moveEventList.empty()) {
@@ -398,6 +465,10 @@ void MoveEvents::addEvent(MoveEvent moveEvent, const Position& pos, MovePosListM
 
 MoveEvent* MoveEvents::getEvent(const Tile* tile, MoveEvent_t eventType)
 {
+	if (positionMap.empty()) {
+		return nullptr;
+	}
+
 	auto it = positionMap.find(tile->getPosition());
 	if (it != positionMap.end()) {
 		std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
@@ -419,6 +490,10 @@ uint32_t MoveEvents::onCreatureMove(Creature* creature, const Tile* tile, MoveEv
 		ret &= moveEvent->fireStepEvent(creature, nullptr, pos);
 	}
 
+	if (!hasTileEvents(tile)) {
+		return ret;
+	}
+
 	for (size_t i = tile->getFirstIndex(), j = tile->getLastIndex(); i < j; ++i) {
 		Thing* thing = tile->getThing(i);
 		if (!thing) {
@@ -478,6 +553,10 @@ uint32_t MoveEvents::onItemMove(Item* item, Tile* tile, bool isAdd)
 		ret &= moveEvent->fireAddRemItem(item, nullptr, tile->getPosition());
 	}
 
+	if (!hasTileEvents(tile)) {
+		return ret;
+	}
+
 	for (size_t i = tile->getFirstIndex(), j = tile->getLastIndex(); i < j; ++i) {
 		Thing* thing = tile->getThing(i);
 		if (!thing) {
@@ -67,15 +67,19 @@ class MoveEvents final : public BaseEvents
 
 		MoveEvent* getEvent(Item* item, MoveEvent_t eventType);
 
+		bool isIndexedItem(const Item* item) const;
+
 		bool registerLuaEvent(MoveEvent* event);
 		bool registerLuaFunction(MoveEvent* event);
 		void clear(bool fromLua) override final;
 
 	private:
-		using MoveListMap = std::map<int32_t, MoveEventList>;
-		using MovePosListMap = std::map<Position, MoveEventList>;
+		using MoveListMap = std::unordered_map<int32_t, MoveEventList>;
+		using MovePosListMap = std::unordered_map<Position, MoveEventList>;
 		void clearMap(MoveListMap& map, bool fromLua);
 		void clearPosMap(MovePosListMap& map, bool fromLua);
+		void indexItemId(int32_t id, MoveEvent_t eventType);
+		bool hasTileEvents(const Tile* tile) const;
 
 		LuaScriptInterface& getScriptInterface() override;
 		std::string getScriptBaseName() const override;
@@ -94,6 +98,13 @@ class MoveEvents final : public BaseEvents
 		MoveListMap itemIdMap;
 		MovePosListMap positionMap;
 
+		// event types registered per item id, so steps over plain items skip the maps
+		std::vector<uint8_t> itemIdEventTypes;
+		// item ids that ever had tile events, tiles holding one carry TILESTATE_MOVEEVENTS
+		std::vector<bool> indexedItemIds;
+		// false once tile events were added for an id after the map had been loaded
+		bool tileFlagsComplete = true;
+
 		LuaScriptInterface scriptInterface;
 };
 
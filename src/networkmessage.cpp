@@ -20,9 +20,7 @@
 #include "otpch.h"
 
 #include "networkmessage.h"
-
-#include "container.h"
-#include "creature.h"
+#include "position.h"
 
 std::string NetworkMessage::getString(uint16_t stringLen/* = 0*/)
 {
@@ -94,45 +92,3 @@ void NetworkMessage::addPosition(const Position& pos)
 	add<uint16_t>(pos.y);
 	addByte(pos.z);
 }
-
-void NetworkMessage::addItem(uint16_t id, uint8_t count)
-{
-	const ItemType& it = Item::items[id];
-
-	add<uint16_t>(it.clientId);
-
-	addByte(0xFF); // MARK_UNMARKED
-
-	if (it.stackable) {
-		addByte(count);
-	} else if (it.isSplash() || it.isFluidContainer()) {
-		addByte(fluidMap[count & 7]);
-	}
-
-	if (it.isAnimation) {
-		addByte(0xFE); // random phase (0xFF for async)
-	}
-}
-
-void NetworkMessage::addItem(const Item* item)
-{
-	const ItemType& it = Item::items[item->getID()];
-
-	add<uint16_t>(it.clientId);
-	addByte(0xFF); // MARK_UNMARKED
-
-	if (it.stackable) {
-		addByte(std::min<uint16_t>(0xFF, item->getItemCount()));
-	} else if (it.isSplash() || it.isFluidContainer()) {
-		addByte(fluidMap[item->getFluidType() & 7]);
-	}
-
-	if (it.isAnimation) {
-		addByte(0xFE); // random phase (0xFF for async)
-	}
-}
-
-void NetworkMessage::addItemId(uint16_t itemId)
-{
-	add<uint16_t>(Item::items[itemId].clientId);
-}
@@ -0,0 +1,68 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "networkmessage.h"
+
+#include "item.h"
+
+// the item writers need the item types, tfs_loadgen links networkmessage.cpp without them
+
+void NetworkMessage::addItem(uint16_t id, uint8_t count)
+{
+	const ItemType& it = Item::items[id];
+
+	add<uint16_t>(it.clientId);
+
+	addByte(0xFF); // MARK_UNMARKED
+
+	if (it.stackable) {
+		addByte(count);
+	} else if (it.isSplash() || it.isFluidContainer()) {
+		addByte(fluidMap[count & 7]);
+	}
+
+	if (it.isAnimation) {
+		addByte(0xFE); // random phase (0xFF for async)
+	}
+}
+
+void NetworkMessage::addItem(const Item* item)
+{
+	const ItemType& it = Item::items[item->getID()];
+
+	add<uint16_t>(it.clientId);
+	addByte(0xFF); // MARK_UNMARKED
+
+	if (it.stackable) {
+		addByte(std::min<uint16_t>(0xFF, item->getItemCount()));
+	} else if (it.isSplash() || it.isFluidContainer()) {
+		addByte(fluidMap[item->getFluidType() & 7]);
+	}
+
+	if (it.isAnimation) {
+		addByte(0xFE); // random phase (0xFF for async)
+	}
+}
+
+void NetworkMessage::addItemId(uint16_t itemId)
+{
+	add<uint16_t>(Item::items[itemId].clientId);
+}
@@ -0,0 +1,258 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "objectpool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+// slabs come straight from the OS, so a released slab leaves the resident set
+// instead of staying in the heap's free lists
+void* mapSlab()
+{
+	constexpr size_t size = SlabAllocator::SLAB_SIZE;
+
+#ifdef _WIN32
+	// allocations are aligned to the 64 KiB allocation granularity
+	void* memory = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	if (!memory) {
+		throw std::bad_alloc();
+	}
+	return memory;
+#else
+	// map twice the size and unmap what lies outside the aligned slab
+	void* mapping = mmap(nullptr, 2 * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapping == MAP_FAILED) {
+		throw std::bad_alloc();
+	}
+
+	char* begin = static_cast<char*>(mapping);
+	char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(begin) + size - 1) & ~static_cast<uintptr_t>(size - 1));
+	if (aligned != begin) {
+		munmap(begin, aligned - begin);
+	}
+	munmap(aligned + size, begin + size - aligned);
+	return aligned;
+#endif
+}
+
+void unmapSlab(void* slab)
+{
+#ifdef _WIN32
+	VirtualFree(slab, 0, MEM_RELEASE);
+#else
+	munmap(slab, SlabAllocator::SLAB_SIZE);
+#endif
+}
+
+}
+
+void* SlabAllocator::allocate(size_t size)
+{
+	if (size == 0 || size > MAX_BLOCK_SIZE) {
+		return ::operator new(size);
+	}
+
+	const size_t index = (size - 1) / GRANULARITY;
+
+	std::lock_guard<std::mutex> lockClass(lock);
+	SizeClass& sizeClass = sizeClasses[index];
+	Slab* slab = sizeClass.head;
+	if (!slab) {
+		slab = createSlab((index + 1) * GRANULARITY);
+		pushFront(sizeClass, slab);
+		++sizeClass.slabs;
+		++sizeClass.emptySlabs;
+		sizeClass.free += slab->blocks;
+	}
+
+	if (slab->used == 0) {
+		--sizeClass.emptySlabs;
+	}
+
+	FreeBlock* block = slab->freeList;
+	slab->freeList = block->next;
+	if (++slab->used == slab->blocks) {
+		unlink(sizeClass, slab);
+	}
+
+	--sizeClass.free;
+	if (++sizeClass.live > sizeClass.peak) {
+		sizeClass.peak = sizeClass.live;
+	}
+	return block;
+}
+
+void SlabAllocator::deallocate(void* p, size_t size)
+{
+	if (!p) {
+		return;
+	}
+
+	if (size == 0 || size > MAX_BLOCK_SIZE) {
+		::operator delete(p);
+		return;
+	}
+
+	Slab* slab = reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(p) & ~static_cast<uintptr_t>(SLAB_SIZE - 1));
+
+	std::lock_guard<std::mutex> lockClass(lock);
+	SizeClass& sizeClass = sizeClasses[(size - 1) / GRANULARITY];
+	FreeBlock* block = static_cast<FreeBlock*>(p);
+	block->next = slab->freeList;
+	slab->freeList = block;
+	--sizeClass.live;
+	++sizeClass.free;
+
+	if (slab->used-- == slab->blocks) {
+		// was full, so it was not linked
+		pushFront(sizeClass, slab);
+	}
+
+	if (slab->used != 0) {
+		return;
+	}
+
+	unlink(sizeClass, slab);
+	if (sizeClass.emptySlabs < MAX_EMPTY_SLABS) {
+		++sizeClass.emptySlabs;
+		pushBack(sizeClass, slab);
+		return;
+	}
+
+	--sizeClass.slabs;
+	sizeClass.free -= slab->blocks;
+	++releasedSlabs;
+
+	slab->~Slab();
+	unmapSlab(slab);
+}
+
+SlabAllocator::Slab* SlabAllocator::createSlab(size_t blockSize)
+{
+	Slab* slab = new (mapSlab()) Slab;
+	char* blocks = reinterpret_cast<char*>(slab) + SLAB_HEADER_SIZE;
+
+	slab->blocks = static_cast<uint32_t>((SLAB_SIZE - SLAB_HEADER_SIZE) / blockSize);
+	for (size_t i = slab->blocks; i-- > 0;) {
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(blocks + i * blockSize);
+		block->next = slab->freeList;
+		slab->freeList = block;
+	}
+	return slab;
+}
+
+void SlabAllocator::pushFront(SizeClass& sizeClass, Slab* slab)
+{
+	slab->prev = nullptr;
+	slab->next = sizeClass.head;
+	if (sizeClass.head) {
+		sizeClass.head->prev = slab;
+	} else {
+		sizeClass.tail = slab;
+	}
+	sizeClass.head = slab;
+}
+
+void SlabAllocator::pushBack(SizeClass& sizeClass, Slab* slab)
+{
+	slab->next = nullptr;
+	slab->prev = sizeClass.tail;
+	if (sizeClass.tail) {
+		sizeClass.tail->next = slab;
+	} else {
+		sizeClass.head = slab;
+	}
+	sizeClass.tail = slab;
+}
+
+void SlabAllocator::unlink(SizeClass& sizeClass, Slab* slab)
+{
+	if (slab->prev) {
+		slab->prev->next = slab->next;
+	} else {
+		sizeClass.head = slab->next;
+	}
+
+	if (slab->next) {
+		slab->next->prev = slab->prev;
+	} else {
+		sizeClass.tail = slab->prev;
+	}
+
+	slab->prev = nullptr;
+	slab->next = nullptr;
+}
+
+std::vector<SlabAllocator::SizeClassStats> SlabAllocator::getStats() const
+{
+	std::vector<SizeClassStats> stats;
+
+	std::lock_guard<std::mutex> lockClass(lock);
+	for (size_t i = 0; i < sizeClasses.size(); ++i) {
+		const SizeClass& sizeClass = sizeClasses[i];
+		if (sizeClass.peak != 0) {
+			stats.push_back({(i + 1) * GRANULARITY, sizeClass.live, sizeClass.free, sizeClass.peak, sizeClass.slabs});
+		}
+	}
+	return stats;
+}
+
+uint64_t SlabAllocator::getReleasedSlabs() const
+{
+	std::lock_guard<std::mutex> lockClass(lock);
+	return releasedSlabs;
+}
+
+// the allocators are never destroyed, objects may still be released during static destruction
+SlabAllocator& getItemAllocator()
+{
+	static SlabAllocator* allocator = new SlabAllocator("Item");
+	return *allocator;
+}
+
+SlabAllocator& getMonsterAllocator()
+{
+	static SlabAllocator* allocator = new SlabAllocator("Monster");
+	return *allocator;
+}
+
+SlabAllocator& getConditionAllocator()
+{
+	static SlabAllocator* allocator = new SlabAllocator("Condition");
+	return *allocator;
+}
+
+void dumpAllocationStats()
+{
+	std::cout << "> Allocation statistics (size: live / free / peak blocks, slabs):" << std::endl;
+	for (const SlabAllocator* allocator : {&getItemAllocator(), &getMonsterAllocator(), &getConditionAllocator()}) {
+		std::cout << allocator->getName() << " (" << allocator->getReleasedSlabs() << " slabs released):" << std::endl;
+		for (const SlabAllocator::SizeClassStats& stats : allocator->getStats()) {
+			std::cout << "  " << stats.size << " bytes: " << stats.live << " / " << stats.free << " / " << stats.peak << ", " << stats.slabs << std::endl;
+		}
+	}
+}
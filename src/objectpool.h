@@ -0,0 +1,107 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_OBJECTPOOL_H_4E1A7C3B9D2F4A6E8B0C5D7F1A3E9B26
+#define FS_OBJECTPOOL_H_4E1A7C3B9D2F4A6E8B0C5D7F1A3E9B26
+
+#include <array>
+
+// Hands out fixed size blocks carved from 64 KiB slabs and recycles them
+// through per slab free lists, so short lived game objects reuse memory
+// instead of fragmenting the heap. A few empty slabs are kept per size
+// class, the ones beyond that are returned to the OS.
+class SlabAllocator
+{
+	public:
+		struct SizeClassStats {
+			size_t size;
+			uint64_t live;
+			uint64_t free;
+			uint64_t peak;
+			uint32_t slabs;
+		};
+
+		explicit SlabAllocator(std::string name) : name(std::move(name)) {}
+
+		// non-copyable
+		SlabAllocator(const SlabAllocator&) = delete;
+		SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+		void* allocate(size_t size);
+		void deallocate(void* p, size_t size);
+
+		const std::string& getName() const {
+			return name;
+		}
+		std::vector<SizeClassStats> getStats() const;
+		uint64_t getReleasedSlabs() const;
+
+		static constexpr size_t SLAB_SIZE = 64 * 1024;
+
+	private:
+		static constexpr size_t GRANULARITY = 16;
+		static constexpr size_t MAX_BLOCK_SIZE = 2048; // bigger objects go to the heap
+		static constexpr uint32_t MAX_EMPTY_SLABS = 4; // per size class, kept to absorb churn without mapping again
+
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		// header at the start of every slab, slabs are aligned to their size
+		// so a block finds its slab by masking its address
+		struct Slab {
+			Slab* prev = nullptr;
+			Slab* next = nullptr;
+			FreeBlock* freeList = nullptr;
+			uint32_t used = 0;
+			uint32_t blocks = 0;
+		};
+
+		static constexpr size_t SLAB_HEADER_SIZE = (sizeof(Slab) + GRANULARITY - 1) / GRANULARITY * GRANULARITY;
+
+		struct SizeClass {
+			// slabs with free blocks, partly used ones first so empty ones can drain
+			Slab* head = nullptr;
+			Slab* tail = nullptr;
+			uint32_t slabs = 0;
+			uint32_t emptySlabs = 0;
+			uint64_t live = 0;
+			uint64_t free = 0;
+			uint64_t peak = 0;
+		};
+
+		static Slab* createSlab(size_t blockSize);
+		static void pushFront(SizeClass& sizeClass, Slab* slab);
+		static void pushBack(SizeClass& sizeClass, Slab* slab);
+		static void unlink(SizeClass& sizeClass, Slab* slab);
+
+		std::string name;
+		std::array<SizeClass, MAX_BLOCK_SIZE / GRANULARITY> sizeClasses;
+		uint64_t releasedSlabs = 0;
+		mutable std::mutex lock;
+};
+
+SlabAllocator& getItemAllocator();
+SlabAllocator& getMonsterAllocator();
+SlabAllocator& getConditionAllocator();
+
+// prints the live, free and peak blocks and the slabs of every size class in use
+void dumpAllocationStats();
+
+#endif
@@ -30,18 +30,28 @@
 #include "rsa.h"
 #include "protocolold.h"
 #include "protocollogin.h"
+#include "protocolmetrics.h"
 #include "protocolstatus.h"
 #include "databasemanager.h"
 #include "scheduler.h"
 #include "databasetasks.h"
+#include "cryptotasks.h"
+#include "lagwatchdog.h"
+#include "workerpool.h"
 #include "script.h"
+#include "tracing.h"
 #include <fstream>
 #include <fmt/format.h>
 #if __has_include("gitmetadata.h")
 	#include "gitmetadata.h"
 #endif
 
+Metrics g_metrics;
+Tracer g_tracer;
 DatabaseTasks g_databaseTasks;
+CryptoTasks g_cryptoTasks;
+LagWatchdog g_lagWatchdog;
+WorkerPool g_workerPool;
 Dispatcher g_dispatcher;
 Scheduler g_scheduler;
 
@@ -99,11 +109,17 @@ int main(int argc, char* argv[])
 		std::cout << ">> No services running. The server is NOT online." << std::endl;
 		g_scheduler.shutdown();
 		g_databaseTasks.shutdown();
+		g_cryptoTasks.shutdown();
+		g_workerPool.shutdown();
+		g_lagWatchdog.shutdown();
 		g_dispatcher.shutdown();
 	}
 
 	g_scheduler.join();
 	g_databaseTasks.join();
+	g_cryptoTasks.join();
+	g_workerPool.join();
+	g_lagWatchdog.join();
 	g_dispatcher.join();
 	return 0;
 }
@@ -195,6 +211,9 @@ void mainLoader(int, char*[], ServiceManager* services)
 		startupErrorMessage(e.what());
 		return;
 	}
+	g_cryptoTasks.start(std::max<int32_t>(0, g_config.getNumber(ConfigManager::CRYPTO_THREADS)));
+	g_workerPool.start(std::max<int32_t>(0, g_config.getNumber(ConfigManager::WORKER_THREADS)));
+	g_lagWatchdog.start(std::max<int32_t>(0, g_config.getNumber(ConfigManager::LAG_WATCHDOG_THRESHOLD)));
 
 	std::cout << ">> Establishing database connection..." << std::flush;
 
@@ -303,6 +322,12 @@ void mainLoader(int, char*[], ServiceManager* services)
 	// Legacy login protocol
 	services->add<ProtocolOld>(static_cast<uint16_t>(g_config.getNumber(ConfigManager::LOGIN_PORT)));
 
+	// Local metrics exporter, disabled unless a port is configured
+	uint16_t metricsPort = static_cast<uint16_t>(g_config.getNumber(ConfigManager::METRICS_PORT));
+	if (metricsPort != 0) {
+		services->add<ProtocolMetrics>(metricsPort, true);
+	}
+
 	RentPeriod_t rentPeriod;
 	std::string strRentPeriod = asLowerCaseString(g_config.getString(ConfigManager::HOUSE_RENT_PERIOD));
 
@@ -798,6 +798,10 @@ void Player::addStorageValue(const uint32_t key, const int32_t value, const bool
 				value >> 16,
 				value & 0xFF
 			);
+			if (isLogin) {
+				// keep the saved row known, genReservedStorageRange erases it once the outfit is gone
+				storage.load(key, value);
+			}
 			return;
 		} else if (IS_IN_KEYRANGE(key, MOUNTS_RANGE)) {
 			// do nothing
@@ -808,33 +812,29 @@ void Player::addStorageValue(const uint32_t key, const int32_t value, const bool
 	}
 
 	if (value != -1) {
+		if (isLogin) {
+			storage.load(key, value);
+			return;
+		}
+
 		int32_t oldValue;
 		getStorageValue(key, oldValue);
 
-		storageMap[key] = value;
+		storage.set(key, value);
 
-		if (!isLogin) {
-			auto currentFrameTime = g_dispatcher.getDispatcherCycle();
-			if (lastQuestlogUpdate != currentFrameTime && g_game.quests.isQuestStorage(key, value, oldValue)) {
-				lastQuestlogUpdate = currentFrameTime;
-				sendTextMessage(MESSAGE_EVENT_ADVANCE, "Your questlog has been updated.");
-			}
+		auto currentFrameTime = g_dispatcher.getDispatcherCycle();
+		if (lastQuestlogUpdate != currentFrameTime && g_game.quests.isQuestStorage(key, value, oldValue)) {
+			lastQuestlogUpdate = currentFrameTime;
+			sendTextMessage(MESSAGE_EVENT_ADVANCE, "Your questlog has been updated.");
 		}
 	} else {
-		storageMap.erase(key);
+		storage.erase(key);
 	}
 }
 
 bool Player::getStorageValue(const uint32_t key, int32_t& value) const
 {
-	auto it = storageMap.find(key);
-	if (it == storageMap.end()) {
-		value = -1;
-		return false;
-	}
-
-	value = it->second;
-	return true;
+	return storage.get(key, value);
 }
 
 bool Player::canSee(const Position& pos) const
@@ -1224,6 +1224,8 @@ void Player::onCreatureAppear(Creature* creature, bool isLogin)
 			condition->setTicks(condition->getTicks() - (offlineTime * 1000));
 			if (condition->getTicks() <= 0) {
 				removeCondition(condition);
+			} else {
+				scheduleCondition(condition);
 			}
 		}
 
@@ -2908,6 +2910,7 @@ void Player::addThing(int32_t index, Thing* thing)
 
 	item->setParent(this);
 	inventory[index] = item;
+	updateItemTypeCounts(item, true);
 
 	//send to client
 	sendInventoryItem(static_cast<slots_t>(index), item);
@@ -2960,6 +2963,8 @@ void Player::replaceThing(uint32_t index, Thing* thing)
 	item->setParent(this);
 
 	inventory[index] = item;
+	updateItemTypeCounts(oldItem, false);
+	updateItemTypeCounts(item, true);
 }
 
 void Player::removeThing(Thing* thing, uint32_t count)
@@ -2984,6 +2989,7 @@ void Player::removeThing(Thing* thing, uint32_t count)
 
 			item->setParent(nullptr);
 			inventory[index] = nullptr;
+			updateItemTypeCounts(item, false);
 		} else {
 			uint8_t newCount = static_cast<uint8_t>(std::max<int32_t>(0, item->getItemCount() - count));
 			item->setItemCount(newCount);
@@ -3003,6 +3009,7 @@ void Player::removeThing(Thing* thing, uint32_t count)
 
 		item->setParent(nullptr);
 		inventory[index] = nullptr;
+		updateItemTypeCounts(item, false);
 	}
 }
 
@@ -3028,26 +3035,57 @@ size_t Player::getLastIndex() const
 
 uint32_t Player::getItemTypeCount(uint16_t itemId, int32_t subType /*= -1*/) const
 {
-	uint32_t count = 0;
-	for (int32_t i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; i++) {
-		Item* item = inventory[i];
-		if (!item) {
-			continue;
+	if (subType == -1) {
+		auto it = itemTypeCounts.find(itemId);
+		return it != itemTypeCounts.end() ? it->second : 0;
+	}
+
+	if (subType < 0 || subType > std::numeric_limits<uint16_t>::max()) {
+		return 0;
+	}
+
+	auto it = itemSubTypeCounts.find((static_cast<uint32_t>(itemId) << 16) | subType);
+	return it != itemSubTypeCounts.end() ? it->second : 0;
+}
+
+void Player::updateItemTypeCount(const Item* item, bool add)
+{
+	uint32_t count = item->getItemCount();
+	if (count == 0) {
+		return;
+	}
+
+	auto update = [count, add](std::unordered_map<uint32_t, uint32_t>& counts, uint32_t key) {
+		if (add) {
+			counts[key] += count;
+			return;
 		}
 
-		if (item->getID() == itemId) {
-			count += Item::countByType(item, subType);
+		auto it = counts.find(key);
+		if (it == counts.end()) {
+			return;
 		}
 
-		if (Container* container = item->getContainer()) {
-			for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
-				if ((*it)->getID() == itemId) {
-					count += Item::countByType(*it, subType);
-				}
-			}
+		if (it->second > count) {
+			it->second -= count;
+		} else {
+			counts.erase(it);
+		}
+	};
+
+	update(itemTypeCounts, item->getID());
+	update(itemSubTypeCounts, (static_cast<uint32_t>(item->getID()) << 16) | item->getSubType());
+}
+
+void Player::updateItemTypeCounts(const Item* item, bool add)
+{
+	updateItemTypeCount(item, add);
+
+	if (const Container* container = item->getContainer()) {
+		for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
+			updateItemTypeCount(*it, add);
 		}
 	}
-	return count;
 }
 
 bool Player::removeItemOfType(uint16_t itemId, uint32_t amount, int32_t subType, bool ignoreEquipped/* = false*/) const
@@ -3103,19 +3141,8 @@ bool Player::removeItemOfType(uint16_t itemId, uint32_t amount, int32_t subType,
 
 std::map<uint32_t, uint32_t>& Player::getAllItemTypeCount(std::map<uint32_t, uint32_t>& countMap) const
 {
-	for (int32_t i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; i++) {
-		Item* item = inventory[i];
-		if (!item) {
-			continue;
-		}
-
-		countMap[item->getID()] += Item::countByType(item, -1);
-
-		if (Container* container = item->getContainer()) {
-			for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
-				countMap[(*it)->getID()] += Item::countByType(*it, -1);
-			}
-		}
+	for (const auto& it : itemTypeCounts) {
+		countMap[it.first] += it.second;
 	}
 	return countMap;
 }
@@ -3295,6 +3322,7 @@ void Player::internalAddThing(uint32_t index, Thing* thing)
 
 		inventory[index] = item;
 		item->setParent(this);
+		updateItemTypeCounts(item, true);
 	}
 }
 
@@ -3966,7 +3994,16 @@ void Player::genReservedStorageRange()
 	//generate outfits range
 	uint32_t base_key = PSTRG_OUTFITS_RANGE_START;
 	for (const OutfitEntry& entry : outfits) {
-		storageMap[++base_key] = (entry.lookType << 16) | entry.addons;
+		storage.set(++base_key, (entry.lookType << 16) | entry.addons);
+	}
+
+	//drop the keys of removed outfits
+	while (++base_key <= static_cast<uint32_t>(PSTRG_OUTFITS_RANGE_START + PSTRG_OUTFITS_RANGE_SIZE)) {
+		int32_t value;
+		if (!storage.get(base_key, value)) {
+			break;
+		}
+		storage.erase(base_key);
 	}
 }
 
@@ -4731,36 +4768,12 @@ void Player::sendClosePrivate(uint16_t channelId)
 
 uint64_t Player::getMoney() const
 {
-	std::vector<const Container*> containers;
-	uint64_t moneyCount = 0;
-
-	for (int32_t i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; ++i) {
-		Item* item = inventory[i];
-		if (!item) {
-			continue;
-		}
+	auto countOf = [this](uint16_t itemId) -> uint64_t {
+		auto it = itemTypeCounts.find(itemId);
+		return it != itemTypeCounts.end() ? it->second : 0;
+	};
 
-		const Container* container = item->getContainer();
-		if (container) {
-			containers.push_back(container);
-		} else {
-			moneyCount += item->getWorth();
-		}
-	}
-
-	size_t i = 0;
-	while (i < containers.size()) {
-		const Container* container = containers[i++];
-		for (const Item* item : container->getItemList()) {
-			const Container* tmpContainer = item->getContainer();
-			if (tmpContainer) {
-				containers.push_back(tmpContainer);
-			} else {
-				moneyCount += item->getWorth();
-			}
-		}
-	}
-	return moneyCount;
+	return countOf(ITEM_GOLD_COIN) + countOf(ITEM_PLATINUM_COIN) * 100 + countOf(ITEM_CRYSTAL_COIN) * 10000;
 }
 
 size_t Player::getMaxVIPEntries() const
@@ -37,6 +37,7 @@
 #include "town.h"
 #include "mounts.h"
 #include "storeinbox.h"
+#include "storagetable.h"
 
 class House;
 class NetworkMessage;
@@ -527,6 +528,10 @@ class Player final : public Creature, public Cylinder
 
 		uint64_t getMoney() const;
 
+		// moves the carried item counts by one item, or by an item and its contents
+		void updateItemTypeCount(const Item* item, bool add);
+		void updateItemTypeCounts(const Item* item, bool add);
+
 		//safe-trade functions
 		void setTradeState(tradestate_t state) {
 			tradeState = state;
@@ -1111,7 +1116,7 @@ class Player final : public Creature, public Cylinder
 			}
 		}
 
-		void sendChannel(uint16_t channelId, const std::string& channelName, const UsersMap* channelUsers, const InvitedMap* invitedUsers) {
+		void sendChannel(uint16_t channelId, const std::string& channelName, const UsersList* channelUsers, const InvitedMap* invitedUsers) {
 			if (client) {
 				client->sendChannel(channelId, channelName, channelUsers, invitedUsers);
 			}
@@ -1234,7 +1239,11 @@ class Player final : public Creature, public Cylinder
 		std::map<uint8_t, OpenContainer> openContainers;
 		std::map<uint32_t, DepotLocker*> depotLockerMap;
 		std::map<uint32_t, DepotChest*> depotChests;
-		std::map<uint32_t, int32_t> storageMap;
+		StorageTable storage;
+
+		//counts of the carried items by id, and by id << 16 | subtype
+		std::unordered_map<uint32_t, uint32_t> itemTypeCounts;
+		std::unordered_map<uint32_t, uint32_t> itemSubTypeCounts;
 
 		std::vector<OutfitEntry> outfits;
 		GuildWarVector guildWarVector;
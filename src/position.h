@@ -128,6 +128,18 @@ struct Position
 	int_fast16_t getZ() const { return z; }
 };
 
+namespace std {
+template <>
+struct hash<Position>
+{
+	size_t operator()(const Position& p) const noexcept {
+		// built in 64 bits, size_t may be 32; folding z into the low half keeps floors apart after truncation
+		uint64_t key = (static_cast<uint64_t>(p.z) << 32) | (static_cast<uint64_t>(p.y) << 16) | p.x;
+		return std::hash<uint64_t>()(key ^ (key >> 32));
+	}
+};
+}
+
 std::ostream& operator<<(std::ostream&, const Position&);
 std::ostream& operator<<(std::ostream&, const Direction&);
 
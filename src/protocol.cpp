@@ -19,12 +19,37 @@
 
 #include "otpch.h"
 
+#include <zlib.h>
+
 #include "protocol.h"
 #include "outputmessage.h"
+#include "configmanager.h"
 #include "rsa.h"
 #include "xtea.h"
 
 extern RSA g_RSA;
+extern ConfigManager g_config;
+
+struct Protocol::ZStream
+{
+	explicit ZStream(int32_t level) {
+		// negative window bits select raw deflate, the client keeps a matching inflate stream
+		valid = deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+	}
+	~ZStream() {
+		if (valid) {
+			deflateEnd(&stream);
+		}
+	}
+
+	// non-copyable
+	ZStream(const ZStream&) = delete;
+	ZStream& operator=(const ZStream&) = delete;
+
+	z_stream stream = {};
+	uint8_t input[NETWORKMESSAGE_MAXSIZE];
+	bool valid = false;
+};
 
 namespace {
 
@@ -60,9 +85,27 @@ bool XTEA_decrypt(NetworkMessage& msg, const xtea::key& key)
 
 }
 
-void Protocol::onSendMessage(const OutputMessage_ptr& msg) const
+Protocol::Protocol(Connection_ptr connection) : connection(connection) {}
+Protocol::~Protocol() = default;
+
+void Protocol::onSendMessage(const OutputMessage_ptr& msg)
 {
 	if (!rawMessages) {
+		if (compressionRequested && !compression) {
+			int32_t level = std::min<int32_t>(g_config.getNumber(ConfigManager::COMPRESSION_LEVEL), Z_BEST_COMPRESSION);
+			if (level > 0) {
+				compression.reset(new ZStream(level));
+				if (!compression->valid) {
+					std::cout << "[Warning - Protocol::onSendMessage] Failed to initialize compression stream." << std::endl;
+				}
+			}
+			compressionRequested = false;
+		}
+
+		if (compression && compression->valid && msg->getLength() >= g_config.getNumber(ConfigManager::COMPRESSION_THRESHOLD)) {
+			compress(*msg);
+		}
+
 		msg->writeMessageLength();
 
 		if (encryptionEnabled) {
@@ -81,6 +124,39 @@ void Protocol::onRecvMessage(NetworkMessage& msg)
 	parsePacket(msg);
 }
 
+void Protocol::compress(OutputMessage& msg)
+{
+	uLong length = msg.getLength();
+
+	// whatever deflate emits must be sent to keep the client's stream in sync,
+	// so skip messages whose compressed form might not fit into the buffer
+	uLong bound = deflateBound(&compression->stream, length) + 6;
+	if (bound + 1 > NetworkMessage::MAX_PROTOCOL_BODY_LENGTH) {
+		return;
+	}
+
+	memcpy(compression->input, msg.getOutputBuffer(), length);
+
+	msg.reset();
+	msg.addByte(COMPRESSED_MESSAGE_OPCODE);
+
+	z_stream& stream = compression->stream;
+	stream.next_in = compression->input;
+	stream.avail_in = length;
+	stream.next_out = msg.getBuffer() + msg.getBufferPosition();
+	stream.avail_out = bound;
+
+	if (deflate(&stream, Z_SYNC_FLUSH) != Z_OK || stream.avail_in != 0) {
+		std::cout << "[Warning - Protocol::compress] Compression stream failed." << std::endl;
+		compression->valid = false;
+		disconnect();
+		return;
+	}
+
+	msg.setLength(1 + bound - stream.avail_out);
+	msg.setBufferPosition(msg.getLength());
+}
+
 OutputMessage_ptr Protocol::getOutputBuffer(int32_t size)
 {
 	//dispatcher thread
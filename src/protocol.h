@@ -20,14 +20,21 @@
 #ifndef FS_PROTOCOL_H_D71405071ACF4137A4B1203899DE80E1
 #define FS_PROTOCOL_H_D71405071ACF4137A4B1203899DE80E1
 
+#include <atomic>
+
 #include "connection.h"
 #include "xtea.h"
 
+// Game packet wrapping a raw deflate block of the connection's compression stream
+static constexpr uint8_t COMPRESSED_MESSAGE_OPCODE = 0x2F;
+
+struct ProtocolTraffic;
+
 class Protocol : public std::enable_shared_from_this<Protocol>
 {
 	public:
-		explicit Protocol(Connection_ptr connection) : connection(connection) {}
-		virtual ~Protocol() = default;
+		explicit Protocol(Connection_ptr connection);
+		virtual ~Protocol();
 
 		// non-copyable
 		Protocol(const Protocol&) = delete;
@@ -35,9 +42,13 @@ class Protocol : public std::enable_shared_from_this<Protocol>
 
 		virtual void parsePacket(NetworkMessage&) {}
 
-		virtual void onSendMessage(const OutputMessage_ptr& msg) const;
+		virtual void onSendMessage(const OutputMessage_ptr& msg);
 		void onRecvMessage(NetworkMessage& msg);
 		virtual void onRecvFirstMessage(NetworkMessage& msg) = 0;
+		// first message carries an RSA block and is handed to the crypto workers
+		virtual bool hasEncryptedFirstMessage() const {
+			return false;
+		}
 		virtual void onConnect() {}
 
 		bool isConnectionExpired() const {
@@ -50,6 +61,11 @@ class Protocol : public std::enable_shared_from_this<Protocol>
 
 		uint32_t getIP() const;
 
+		// byte counters of the service this protocol was created by
+		void setTraffic(ProtocolTraffic* traffic) {
+			this->traffic = traffic;
+		}
+
 		//Use this function for autosend messages only
 		OutputMessage_ptr getOutputBuffer(int32_t size);
 
@@ -85,18 +101,30 @@ class Protocol : public std::enable_shared_from_this<Protocol>
 			rawMessages = value;
 		}
 
+		// may be called from any thread, the stream is created by the next send
+		void enableCompression() {
+			compressionRequested = true;
+		}
+
 		virtual void release() {}
 
 	private:
+		struct ZStream;
+
+		void compress(OutputMessage& msg);
+
 		friend class Connection;
 
 		OutputMessage_ptr outputBuffer;
+		std::unique_ptr<ZStream> compression;
 
 		const ConnectionWeak_ptr connection;
+		ProtocolTraffic* traffic = nullptr;
 		xtea::key key;
 		bool encryptionEnabled = false;
 		bool checksumEnabled = true;
 		bool rawMessages = false;
+		std::atomic<bool> compressionRequested{false};
 };
 
 #endif
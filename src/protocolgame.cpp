@@ -136,6 +136,48 @@ std::size_t clientLogin(const Player& player)
 	return currentSlot;
 }
 
+const TileDescriptionCache& getTileDescriptionCache(const Tile* tile)
+{
+	TileDescriptionCache& cache = tile->getDescriptionCache();
+	if (cache.isValid()) {
+		return cache;
+	}
+
+	// only used from the dispatcher thread
+	static NetworkMessage itemMsg;
+	itemMsg.reset();
+
+	uint8_t count = 0;
+	auto addItem = [&](const Item* item) {
+		itemMsg.addItem(item);
+		cache.ends[count++] = itemMsg.getLength();
+	};
+
+	if (const Item* ground = tile->getGround()) {
+		addItem(ground);
+	}
+
+	const TileItemVector* items = tile->getItemList();
+	if (items) {
+		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end && count < TileDescriptionCache::MAX_ITEMS; ++it) {
+			addItem(*it);
+		}
+	}
+
+	cache.topCount = count;
+
+	if (items) {
+		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end && count < TileDescriptionCache::MAX_ITEMS; ++it) {
+			addItem(*it);
+		}
+	}
+
+	cache.downCount = count - cache.topCount;
+	memcpy(cache.bytes, itemMsg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION, itemMsg.getLength());
+	cache.setValid();
+	return cache;
+}
+
 }
 
 void ProtocolGame::release()
@@ -476,6 +518,15 @@ void ProtocolGame::disconnectClient(const std::string& message) const
 	disconnect();
 }
 
+void ProtocolGame::addPlayerTask(Task* task, const char* tag)
+{
+	task->setTag(tag);
+	if (player) {
+		task->setPlayerId(player->getID());
+	}
+	g_dispatcher.addTask(task);
+}
+
 void ProtocolGame::writeToOutputBuffer(const NetworkMessage& msg)
 {
 	auto out = getOutputBuffer(msg.getLength());
@@ -512,33 +563,33 @@ void ProtocolGame::parsePacket(NetworkMessage& msg)
 
 	switch (recvbyte) {
 		case 0x14: g_dispatcher.addTask(createTask(std::bind(&ProtocolGame::logout, getThis(), true, false))); break;
-		case 0x1D: addGameTask(&Game::playerReceivePingBack, player->getID()); break;
-		case 0x1E: addGameTask(&Game::playerReceivePing, player->getID()); break;
+		case 0x1D: addGameTask(GAME_TASK(playerReceivePingBack), player->getID()); break;
+		case 0x1E: addGameTask(GAME_TASK(playerReceivePing), player->getID()); break;
 		case 0x32: parseExtendedOpcode(msg); break; //otclient extended opcode
 		case 0x64: parseAutoWalk(msg); break;
-		case 0x65: addGameTask(&Game::playerMove, player->getID(), DIRECTION_NORTH); break;
-		case 0x66: addGameTask(&Game::playerMove, player->getID(), DIRECTION_EAST); break;
-		case 0x67: addGameTask(&Game::playerMove, player->getID(), DIRECTION_SOUTH); break;
-		case 0x68: addGameTask(&Game::playerMove, player->getID(), DIRECTION_WEST); break;
-		case 0x69: addGameTask(&Game::playerStopAutoWalk, player->getID()); break;
-		case 0x6A: addGameTask(&Game::playerMove, player->getID(), DIRECTION_NORTHEAST); break;
-		case 0x6B: addGameTask(&Game::playerMove, player->getID(), DIRECTION_SOUTHEAST); break;
-		case 0x6C: addGameTask(&Game::playerMove, player->getID(), DIRECTION_SOUTHWEST); break;
-		case 0x6D: addGameTask(&Game::playerMove, player->getID(), DIRECTION_NORTHWEST); break;
-		case 0x6F: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerTurn, player->getID(), DIRECTION_NORTH); break;
-		case 0x70: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerTurn, player->getID(), DIRECTION_EAST); break;
-		case 0x71: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerTurn, player->getID(), DIRECTION_SOUTH); break;
-		case 0x72: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerTurn, player->getID(), DIRECTION_WEST); break;
+		case 0x65: addGameTask(GAME_TASK(playerMove), player->getID(), DIRECTION_NORTH); break;
+		case 0x66: addGameTask(GAME_TASK(playerMove), player->getID(), DIRECTION_EAST); break;
+		case 0x67: addGameTask(GAME_TASK(playerMove), player->getID(), DIRECTION_SOUTH); break;
+		case 0x68: addGameTask(GAME_TASK(playerMove), player->getID(), DIRECTION_WEST); break;
+		case 0x69: addGameTask(GAME_TASK(playerStopAutoWalk), player->getID()); break;
+		case 0x6A: addGameTask(GAME_TASK(playerMove), player->getID(), DIRECTION_NORTHEAST); break;
+		case 0x6B: addGameTask(GAME_TASK(playerMove), player->getID(), DIRECTION_SOUTHEAST); break;
+		case 0x6C: addGameTask(GAME_TASK(playerMove), player->getID(), DIRECTION_SOUTHWEST); break;
+		case 0x6D: addGameTask(GAME_TASK(playerMove), player->getID(), DIRECTION_NORTHWEST); break;
+		case 0x6F: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerTurn), player->getID(), DIRECTION_NORTH); break;
+		case 0x70: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerTurn), player->getID(), DIRECTION_EAST); break;
+		case 0x71: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerTurn), player->getID(), DIRECTION_SOUTH); break;
+		case 0x72: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerTurn), player->getID(), DIRECTION_WEST); break;
 		case 0x77: parseEquipObject(msg); break;
 		case 0x78: parseThrow(msg); break;
 		case 0x79: parseLookInShop(msg); break;
 		case 0x7A: parsePlayerPurchase(msg); break;
 		case 0x7B: parsePlayerSale(msg); break;
-		case 0x7C: addGameTask(&Game::playerCloseShop, player->getID()); break;
+		case 0x7C: addGameTask(GAME_TASK(playerCloseShop), player->getID()); break;
 		case 0x7D: parseRequestTrade(msg); break;
 		case 0x7E: parseLookInTrade(msg); break;
-		case 0x7F: addGameTask(&Game::playerAcceptTrade, player->getID()); break;
-		case 0x80: addGameTask(&Game::playerCloseTrade, player->getID()); break;
+		case 0x7F: addGameTask(GAME_TASK(playerAcceptTrade), player->getID()); break;
+		case 0x80: addGameTask(GAME_TASK(playerCloseTrade), player->getID()); break;
 		case 0x82: parseUseItem(msg); break;
 		case 0x83: parseUseItemEx(msg); break;
 		case 0x84: parseUseWithCreature(msg); break;
@@ -552,11 +603,11 @@ void ProtocolGame::parsePacket(NetworkMessage& msg)
 		case 0x8D: parseLookInBattleList(msg); break;
 		case 0x8E: /* join aggression */ break;
 		case 0x96: parseSay(msg); break;
-		case 0x97: addGameTask(&Game::playerRequestChannels, player->getID()); break;
+		case 0x97: addGameTask(GAME_TASK(playerRequestChannels), player->getID()); break;
 		case 0x98: parseOpenChannel(msg); break;
 		case 0x99: parseCloseChannel(msg); break;
 		case 0x9A: parseOpenPrivateChannel(msg); break;
-		case 0x9E: addGameTask(&Game::playerCloseNpcChannel, player->getID()); break;
+		case 0x9E: addGameTask(GAME_TASK(playerCloseNpcChannel), player->getID()); break;
 		case 0xA0: parseFightModes(msg); break;
 		case 0xA1: parseAttack(msg); break;
 		case 0xA2: parseFollow(msg); break;
@@ -564,17 +615,17 @@ void ProtocolGame::parsePacket(NetworkMessage& msg)
 		case 0xA4: parseJoinParty(msg); break;
 		case 0xA5: parseRevokePartyInvite(msg); break;
 		case 0xA6: parsePassPartyLeadership(msg); break;
-		case 0xA7: addGameTask(&Game::playerLeaveParty, player->getID()); break;
+		case 0xA7: addGameTask(GAME_TASK(playerLeaveParty), player->getID()); break;
 		case 0xA8: parseEnableSharedPartyExperience(msg); break;
-		case 0xAA: addGameTask(&Game::playerCreatePrivateChannel, player->getID()); break;
+		case 0xAA: addGameTask(GAME_TASK(playerCreatePrivateChannel), player->getID()); break;
 		case 0xAB: parseChannelInvite(msg); break;
 		case 0xAC: parseChannelExclude(msg); break;
-		case 0xBE: addGameTask(&Game::playerCancelAttackAndFollow, player->getID()); break;
+		case 0xBE: addGameTask(GAME_TASK(playerCancelAttackAndFollow), player->getID()); break;
 		case 0xC9: /* update tile */ break;
 		case 0xCA: parseUpdateContainer(msg); break;
 		case 0xCB: parseBrowseField(msg); break;
 		case 0xCC: parseSeekInContainer(msg); break;
-		case 0xD2: addGameTask(&Game::playerRequestOutfit, player->getID()); break;
+		case 0xD2: addGameTask(GAME_TASK(playerRequestOutfit), player->getID()); break;
 		case 0xD3: parseSetOutfit(msg); break;
 		case 0xD4: parseToggleMount(msg); break;
 		case 0xDC: parseAddVip(msg); break;
@@ -583,7 +634,7 @@ void ProtocolGame::parsePacket(NetworkMessage& msg)
 		case 0xE6: parseBugReport(msg); break;
 		case 0xE7: /* thank you */ break;
 		case 0xE8: parseDebugAssert(msg); break;
-		case 0xF0: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerShowQuestLog, player->getID()); break;
+		case 0xF0: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerShowQuestLog), player->getID()); break;
 		case 0xF1: parseQuestLine(msg); break;
 		case 0xF2: parseRuleViolationReport(msg); break;
 		case 0xF3: /* get object info */ break;
@@ -608,24 +659,12 @@ void ProtocolGame::GetTileDescription(const Tile* tile, NetworkMessage& msg)
 {
 	msg.add<uint16_t>(0x00); //environmental effects
 
-	int32_t count;
-	Item* ground = tile->getGround();
-	if (ground) {
-		msg.addItem(ground);
-		count = 1;
-	} else {
-		count = 0;
-	}
-
-	const TileItemVector* items = tile->getItemList();
-	if (items) {
-		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
-			msg.addItem(*it);
+	const TileDescriptionCache& cache = getTileDescriptionCache(tile);
+	const char* bytes = reinterpret_cast<const char*>(cache.bytes);
 
-			if (++count == 10) {
-				break;
-			}
-		}
+	int32_t count = cache.topCount;
+	if (count != 0) {
+		msg.addBytes(bytes, cache.ends[count - 1]);
 	}
 
 	const CreatureVector* creatures = tile->getCreatures();
@@ -643,14 +682,11 @@ void ProtocolGame::GetTileDescription(const Tile* tile, NetworkMessage& msg)
 		}
 	}
 
-	if (items && count < 10) {
-		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
-			msg.addItem(*it);
-
-			if (++count == 10) {
-				return;
-			}
-		}
+	if (cache.downCount != 0 && count < 10) {
+		int32_t downCount = std::min<int32_t>(cache.downCount, 10 - count);
+		uint8_t begin = cache.topCount != 0 ? cache.ends[cache.topCount - 1] : 0;
+		uint8_t end = cache.ends[cache.topCount + downCount - 1];
+		msg.addBytes(bytes + begin, end - begin);
 	}
 }
 
@@ -682,8 +718,23 @@ void ProtocolGame::GetMapDescription(int32_t x, int32_t y, int32_t z, int32_t wi
 void ProtocolGame::GetFloorDescription(NetworkMessage& msg, int32_t x, int32_t y, int32_t z, int32_t width, int32_t height, int32_t offset, int32_t& skip)
 {
 	for (int32_t nx = 0; nx < width; nx++) {
+		uint16_t tileX = x + nx + offset;
+
+		// walk down the column leaf by leaf instead of descending the tree for every tile
+		const QTreeLeafNode* leaf = nullptr;
+		const Floor* floor = nullptr;
 		for (int32_t ny = 0; ny < height; ny++) {
-			Tile* tile = g_game.map.getTile(x + nx + offset, y + ny + offset, z);
+			uint16_t tileY = y + ny + offset;
+			if (ny == 0 || (tileY & FLOOR_MASK) == 0) {
+				if (leaf && ny != 0) {
+					leaf = leaf->getSouthLeaf();
+				} else {
+					leaf = g_game.map.getQTNode(tileX, tileY);
+				}
+				floor = leaf ? leaf->getFloor(z) : nullptr;
+			}
+
+			Tile* tile = floor ? floor->tiles[tileX & FLOOR_MASK][tileY & FLOOR_MASK] : nullptr;
 			if (tile) {
 				if (skip >= 0) {
 					msg.addByte(skip);
@@ -789,31 +840,31 @@ bool ProtocolGame::canSee(int32_t x, int32_t y, int32_t z) const
 void ProtocolGame::parseChannelInvite(NetworkMessage& msg)
 {
 	const std::string name = msg.getString();
-	addGameTask(&Game::playerChannelInvite, player->getID(), name);
+	addGameTask(GAME_TASK(playerChannelInvite), player->getID(), name);
 }
 
 void ProtocolGame::parseChannelExclude(NetworkMessage& msg)
 {
 	const std::string name = msg.getString();
-	addGameTask(&Game::playerChannelExclude, player->getID(), name);
+	addGameTask(GAME_TASK(playerChannelExclude), player->getID(), name);
 }
 
 void ProtocolGame::parseOpenChannel(NetworkMessage& msg)
 {
 	uint16_t channelId = msg.get<uint16_t>();
-	addGameTask(&Game::playerOpenChannel, player->getID(), channelId);
+	addGameTask(GAME_TASK(playerOpenChannel), player->getID(), channelId);
 }
 
 void ProtocolGame::parseCloseChannel(NetworkMessage& msg)
 {
 	uint16_t channelId = msg.get<uint16_t>();
-	addGameTask(&Game::playerCloseChannel, player->getID(), channelId);
+	addGameTask(GAME_TASK(playerCloseChannel), player->getID(), channelId);
 }
 
 void ProtocolGame::parseOpenPrivateChannel(NetworkMessage& msg)
 {
 	const std::string receiver = msg.getString();
-	addGameTask(&Game::playerOpenPrivateChannel, player->getID(), receiver);
+	addGameTask(GAME_TASK(playerOpenPrivateChannel), player->getID(), receiver);
 }
 
 void ProtocolGame::parseAutoWalk(NetworkMessage& msg)
@@ -847,7 +898,7 @@ void ProtocolGame::parseAutoWalk(NetworkMessage& msg)
 		return;
 	}
 
-	addGameTask(&Game::playerAutoWalk, player->getID(), std::move(path));
+	addGameTask(GAME_TASK(playerAutoWalk), player->getID(), std::move(path));
 }
 
 void ProtocolGame::parseSetOutfit(NetworkMessage& msg)
@@ -860,13 +911,13 @@ void ProtocolGame::parseSetOutfit(NetworkMessage& msg)
 	newOutfit.lookFeet = msg.getByte();
 	newOutfit.lookAddons = msg.getByte();
 	newOutfit.lookMount = msg.get<uint16_t>();
-	addGameTask(&Game::playerChangeOutfit, player->getID(), newOutfit);
+	addGameTask(GAME_TASK(playerChangeOutfit), player->getID(), newOutfit);
 }
 
 void ProtocolGame::parseToggleMount(NetworkMessage& msg)
 {
 	bool mount = msg.getByte() != 0;
-	addGameTask(&Game::playerToggleMount, player->getID(), mount);
+	addGameTask(GAME_TASK(playerToggleMount), player->getID(), mount);
 }
 
 void ProtocolGame::parseUseItem(NetworkMessage& msg)
@@ -875,7 +926,7 @@ void ProtocolGame::parseUseItem(NetworkMessage& msg)
 	uint16_t spriteId = msg.get<uint16_t>();
 	uint8_t stackpos = msg.getByte();
 	uint8_t index = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerUseItem, player->getID(), pos, stackpos, index, spriteId);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerUseItem), player->getID(), pos, stackpos, index, spriteId);
 }
 
 void ProtocolGame::parseUseItemEx(NetworkMessage& msg)
@@ -886,7 +937,7 @@ void ProtocolGame::parseUseItemEx(NetworkMessage& msg)
 	Position toPos = msg.getPosition();
 	uint16_t toSpriteId = msg.get<uint16_t>();
 	uint8_t toStackPos = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerUseItemEx, player->getID(), fromPos, fromStackPos, fromSpriteId, toPos, toStackPos, toSpriteId);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerUseItemEx), player->getID(), fromPos, fromStackPos, fromSpriteId, toPos, toStackPos, toSpriteId);
 }
 
 void ProtocolGame::parseUseWithCreature(NetworkMessage& msg)
@@ -895,25 +946,25 @@ void ProtocolGame::parseUseWithCreature(NetworkMessage& msg)
 	uint16_t spriteId = msg.get<uint16_t>();
 	uint8_t fromStackPos = msg.getByte();
 	uint32_t creatureId = msg.get<uint32_t>();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerUseWithCreature, player->getID(), fromPos, fromStackPos, creatureId, spriteId);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerUseWithCreature), player->getID(), fromPos, fromStackPos, creatureId, spriteId);
 }
 
 void ProtocolGame::parseCloseContainer(NetworkMessage& msg)
 {
 	uint8_t cid = msg.getByte();
-	addGameTask(&Game::playerCloseContainer, player->getID(), cid);
+	addGameTask(GAME_TASK(playerCloseContainer), player->getID(), cid);
 }
 
 void ProtocolGame::parseUpArrowContainer(NetworkMessage& msg)
 {
 	uint8_t cid = msg.getByte();
-	addGameTask(&Game::playerMoveUpContainer, player->getID(), cid);
+	addGameTask(GAME_TASK(playerMoveUpContainer), player->getID(), cid);
 }
 
 void ProtocolGame::parseUpdateContainer(NetworkMessage& msg)
 {
 	uint8_t cid = msg.getByte();
-	addGameTask(&Game::playerUpdateContainer, player->getID(), cid);
+	addGameTask(GAME_TASK(playerUpdateContainer), player->getID(), cid);
 }
 
 void ProtocolGame::parseThrow(NetworkMessage& msg)
@@ -925,7 +976,7 @@ void ProtocolGame::parseThrow(NetworkMessage& msg)
 	uint8_t count = msg.getByte();
 
 	if (toPos != fromPos) {
-		addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerMoveThing, player->getID(), fromPos, spriteId, fromStackpos, toPos, count);
+		addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerMoveThing), player->getID(), fromPos, spriteId, fromStackpos, toPos, count);
 	}
 }
 
@@ -934,13 +985,13 @@ void ProtocolGame::parseLookAt(NetworkMessage& msg)
 	Position pos = msg.getPosition();
 	msg.skipBytes(2); // spriteId
 	uint8_t stackpos = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerLookAt, player->getID(), pos, stackpos);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerLookAt), player->getID(), pos, stackpos);
 }
 
 void ProtocolGame::parseLookInBattleList(NetworkMessage& msg)
 {
 	uint32_t creatureId = msg.get<uint32_t>();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerLookInBattleList, player->getID(), creatureId);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerLookInBattleList), player->getID(), creatureId);
 }
 
 void ProtocolGame::parseSay(NetworkMessage& msg)
@@ -971,7 +1022,7 @@ void ProtocolGame::parseSay(NetworkMessage& msg)
 		return;
 	}
 
-	addGameTask(&Game::playerSay, player->getID(), channelId, type, receiver, text);
+	addGameTask(GAME_TASK(playerSay), player->getID(), channelId, type, receiver, text);
 }
 
 void ProtocolGame::parseFightModes(NetworkMessage& msg)
@@ -990,21 +1041,21 @@ void ProtocolGame::parseFightModes(NetworkMessage& msg)
 		fightMode = FIGHTMODE_DEFENSE;
 	}
 
-	addGameTask(&Game::playerSetFightModes, player->getID(), fightMode, rawChaseMode != 0, rawSecureMode != 0);
+	addGameTask(GAME_TASK(playerSetFightModes), player->getID(), fightMode, rawChaseMode != 0, rawSecureMode != 0);
 }
 
 void ProtocolGame::parseAttack(NetworkMessage& msg)
 {
 	uint32_t creatureId = msg.get<uint32_t>();
 	// msg.get<uint32_t>(); creatureId (same as above)
-	addGameTask(&Game::playerSetAttackedCreature, player->getID(), creatureId);
+	addGameTask(GAME_TASK(playerSetAttackedCreature), player->getID(), creatureId);
 }
 
 void ProtocolGame::parseFollow(NetworkMessage& msg)
 {
 	uint32_t creatureId = msg.get<uint32_t>();
 	// msg.get<uint32_t>(); creatureId (same as above)
-	addGameTask(&Game::playerFollowCreature, player->getID(), creatureId);
+	addGameTask(GAME_TASK(playerFollowCreature), player->getID(), creatureId);
 }
 
 void ProtocolGame::parseEquipObject(NetworkMessage& msg)
@@ -1012,14 +1063,14 @@ void ProtocolGame::parseEquipObject(NetworkMessage& msg)
 	uint16_t spriteId = msg.get<uint16_t>();
 	// msg.get<uint8_t>();
 
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerEquipItem, player->getID(), spriteId);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerEquipItem), player->getID(), spriteId);
 }
 
 void ProtocolGame::parseTextWindow(NetworkMessage& msg)
 {
 	uint32_t windowTextId = msg.get<uint32_t>();
 	const std::string newText = msg.getString();
-	addGameTask(&Game::playerWriteItem, player->getID(), windowTextId, newText);
+	addGameTask(GAME_TASK(playerWriteItem), player->getID(), windowTextId, newText);
 }
 
 void ProtocolGame::parseHouseWindow(NetworkMessage& msg)
@@ -1027,7 +1078,7 @@ void ProtocolGame::parseHouseWindow(NetworkMessage& msg)
 	uint8_t doorId = msg.getByte();
 	uint32_t id = msg.get<uint32_t>();
 	const std::string text = msg.getString();
-	addGameTask(&Game::playerUpdateHouseWindow, player->getID(), doorId, id, text);
+	addGameTask(GAME_TASK(playerUpdateHouseWindow), player->getID(), doorId, id, text);
 }
 
 void ProtocolGame::parseWrapItem(NetworkMessage& msg)
@@ -1035,14 +1086,14 @@ void ProtocolGame::parseWrapItem(NetworkMessage& msg)
 	Position pos = msg.getPosition();
 	uint16_t spriteId = msg.get<uint16_t>();
 	uint8_t stackpos = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerWrapItem, player->getID(), pos, stackpos, spriteId);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerWrapItem), player->getID(), pos, stackpos, spriteId);
 }
 
 void ProtocolGame::parseLookInShop(NetworkMessage& msg)
 {
 	uint16_t id = msg.get<uint16_t>();
 	uint8_t count = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerLookInShop, player->getID(), id, count);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerLookInShop), player->getID(), id, count);
 }
 
 void ProtocolGame::parsePlayerPurchase(NetworkMessage& msg)
@@ -1052,7 +1103,7 @@ void ProtocolGame::parsePlayerPurchase(NetworkMessage& msg)
 	uint8_t amount = msg.getByte();
 	bool ignoreCap = msg.getByte() != 0;
 	bool inBackpacks = msg.getByte() != 0;
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerPurchaseItem, player->getID(), id, count, amount, ignoreCap, inBackpacks);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerPurchaseItem), player->getID(), id, count, amount, ignoreCap, inBackpacks);
 }
 
 void ProtocolGame::parsePlayerSale(NetworkMessage& msg)
@@ -1061,7 +1112,7 @@ void ProtocolGame::parsePlayerSale(NetworkMessage& msg)
 	uint8_t count = msg.getByte();
 	uint8_t amount = msg.getByte();
 	bool ignoreEquipped = msg.getByte() != 0;
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerSellItem, player->getID(), id, count, amount, ignoreEquipped);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerSellItem), player->getID(), id, count, amount, ignoreEquipped);
 }
 
 void ProtocolGame::parseRequestTrade(NetworkMessage& msg)
@@ -1070,26 +1121,26 @@ void ProtocolGame::parseRequestTrade(NetworkMessage& msg)
 	uint16_t spriteId = msg.get<uint16_t>();
 	uint8_t stackpos = msg.getByte();
 	uint32_t playerId = msg.get<uint32_t>();
-	addGameTask(&Game::playerRequestTrade, player->getID(), pos, stackpos, playerId, spriteId);
+	addGameTask(GAME_TASK(playerRequestTrade), player->getID(), pos, stackpos, playerId, spriteId);
 }
 
 void ProtocolGame::parseLookInTrade(NetworkMessage& msg)
 {
 	bool counterOffer = (msg.getByte() == 0x01);
 	uint8_t index = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerLookInTrade, player->getID(), counterOffer, index);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerLookInTrade), player->getID(), counterOffer, index);
 }
 
 void ProtocolGame::parseAddVip(NetworkMessage& msg)
 {
 	const std::string name = msg.getString();
-	addGameTask(&Game::playerRequestAddVip, player->getID(), name);
+	addGameTask(GAME_TASK(playerRequestAddVip), player->getID(), name);
 }
 
 void ProtocolGame::parseRemoveVip(NetworkMessage& msg)
 {
 	uint32_t guid = msg.get<uint32_t>();
-	addGameTask(&Game::playerRequestRemoveVip, player->getID(), guid);
+	addGameTask(GAME_TASK(playerRequestRemoveVip), player->getID(), guid);
 }
 
 void ProtocolGame::parseEditVip(NetworkMessage& msg)
@@ -1098,7 +1149,7 @@ void ProtocolGame::parseEditVip(NetworkMessage& msg)
 	const std::string description = msg.getString();
 	uint32_t icon = std::min<uint32_t>(10, msg.get<uint32_t>()); // 10 is max icon in 9.63
 	bool notify = msg.getByte() != 0;
-	addGameTask(&Game::playerRequestEditVip, player->getID(), guid, description, icon, notify);
+	addGameTask(GAME_TASK(playerRequestEditVip), player->getID(), guid, description, icon, notify);
 }
 
 void ProtocolGame::parseRotateItem(NetworkMessage& msg)
@@ -1106,7 +1157,7 @@ void ProtocolGame::parseRotateItem(NetworkMessage& msg)
 	Position pos = msg.getPosition();
 	uint16_t spriteId = msg.get<uint16_t>();
 	uint8_t stackpos = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, &Game::playerRotateItem, player->getID(), pos, stackpos, spriteId);
+	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, GAME_TASK(playerRotateItem), player->getID(), pos, stackpos, spriteId);
 }
 
 void ProtocolGame::parseRuleViolationReport(NetworkMessage& msg)
@@ -1123,7 +1174,7 @@ void ProtocolGame::parseRuleViolationReport(NetworkMessage& msg)
 		msg.get<uint32_t>(); // statement id, used to get whatever player have said, we don't log that.
 	}
 
-	addGameTask(&Game::playerReportRuleViolation, player->getID(), targetName, reportType, reportReason, comment, translation);
+	addGameTask(GAME_TASK(playerReportRuleViolation), player->getID(), targetName, reportType, reportReason, comment, translation);
 }
 
 void ProtocolGame::parseBugReport(NetworkMessage& msg)
@@ -1136,7 +1187,7 @@ void ProtocolGame::parseBugReport(NetworkMessage& msg)
 		position = msg.getPosition();
 	}
 
-	addGameTask(&Game::playerReportBug, player->getID(), message, position, category);
+	addGameTask(GAME_TASK(playerReportBug), player->getID(), message, position, category);
 }
 
 void ProtocolGame::parseDebugAssert(NetworkMessage& msg)
@@ -1151,48 +1202,48 @@ void ProtocolGame::parseDebugAssert(NetworkMessage& msg)
 	std::string date = msg.getString();
 	std::string description = msg.getString();
 	std::string comment = msg.getString();
-	addGameTask(&Game::playerDebugAssert, player->getID(), assertLine, date, description, comment);
+	addGameTask(GAME_TASK(playerDebugAssert), player->getID(), assertLine, date, description, comment);
 }
 
 void ProtocolGame::parseInviteToParty(NetworkMessage& msg)
 {
 	uint32_t targetId = msg.get<uint32_t>();
-	addGameTask(&Game::playerInviteToParty, player->getID(), targetId);
+	addGameTask(GAME_TASK(playerInviteToParty), player->getID(), targetId);
 }
 
 void ProtocolGame::parseJoinParty(NetworkMessage& msg)
 {
 	uint32_t targetId = msg.get<uint32_t>();
-	addGameTask(&Game::playerJoinParty, player->getID(), targetId);
+	addGameTask(GAME_TASK(playerJoinParty), player->getID(), targetId);
 }
 
 void ProtocolGame::parseRevokePartyInvite(NetworkMessage& msg)
 {
 	uint32_t targetId = msg.get<uint32_t>();
-	addGameTask(&Game::playerRevokePartyInvitation, player->getID(), targetId);
+	addGameTask(GAME_TASK(playerRevokePartyInvitation), player->getID(), targetId);
 }
 
 void ProtocolGame::parsePassPartyLeadership(NetworkMessage& msg)
 {
 	uint32_t targetId = msg.get<uint32_t>();
-	addGameTask(&Game::playerPassPartyLeadership, player->getID(), targetId);
+	addGameTask(GAME_TASK(playerPassPartyLeadership), player->getID(), targetId);
 }
 
 void ProtocolGame::parseEnableSharedPartyExperience(NetworkMessage& msg)
 {
 	bool sharedExpActive = msg.getByte() == 1;
-	addGameTask(&Game::playerEnableSharedPartyExperience, player->getID(), sharedExpActive);
+	addGameTask(GAME_TASK(playerEnableSharedPartyExperience), player->getID(), sharedExpActive);
 }
 
 void ProtocolGame::parseQuestLine(NetworkMessage& msg)
 {
 	uint16_t questId = msg.get<uint16_t>();
-	addGameTask(&Game::playerShowQuestLine, player->getID(), questId);
+	addGameTask(GAME_TASK(playerShowQuestLine), player->getID(), questId);
 }
 
 void ProtocolGame::parseMarketLeave()
 {
-	addGameTask(&Game::playerLeaveMarket, player->getID());
+	addGameTask(GAME_TASK(playerLeaveMarket), player->getID());
 }
 
 void ProtocolGame::parseMarketBrowse(NetworkMessage& msg)
@@ -1200,11 +1251,11 @@ void ProtocolGame::parseMarketBrowse(NetworkMessage& msg)
 	uint16_t browseId = msg.get<uint16_t>();
 
 	if (browseId == MARKETREQUEST_OWN_OFFERS) {
-		addGameTask(&Game::playerBrowseMarketOwnOffers, player->getID());
+		addGameTask(GAME_TASK(playerBrowseMarketOwnOffers), player->getID());
 	} else if (browseId == MARKETREQUEST_OWN_HISTORY) {
-		addGameTask(&Game::playerBrowseMarketOwnHistory, player->getID());
+		addGameTask(GAME_TASK(playerBrowseMarketOwnHistory), player->getID());
 	} else {
-		addGameTask(&Game::playerBrowseMarket, player->getID(), browseId);
+		addGameTask(GAME_TASK(playerBrowseMarket), player->getID(), browseId);
 	}
 }
 
@@ -1215,14 +1266,14 @@ void ProtocolGame::parseMarketCreateOffer(NetworkMessage& msg)
 	uint16_t amount = msg.get<uint16_t>();
 	uint32_t price = msg.get<uint32_t>();
 	bool anonymous = (msg.getByte() != 0);
-	addGameTask(&Game::playerCreateMarketOffer, player->getID(), type, spriteId, amount, price, anonymous);
+	addGameTask(GAME_TASK(playerCreateMarketOffer), player->getID(), type, spriteId, amount, price, anonymous);
 }
 
 void ProtocolGame::parseMarketCancelOffer(NetworkMessage& msg)
 {
 	uint32_t timestamp = msg.get<uint32_t>();
 	uint16_t counter = msg.get<uint16_t>();
-	addGameTask(&Game::playerCancelMarketOffer, player->getID(), timestamp, counter);
+	addGameTask(GAME_TASK(playerCancelMarketOffer), player->getID(), timestamp, counter);
 }
 
 void ProtocolGame::parseMarketAcceptOffer(NetworkMessage& msg)
@@ -1230,7 +1281,7 @@ void ProtocolGame::parseMarketAcceptOffer(NetworkMessage& msg)
 	uint32_t timestamp = msg.get<uint32_t>();
 	uint16_t counter = msg.get<uint16_t>();
 	uint16_t amount = msg.get<uint16_t>();
-	addGameTask(&Game::playerAcceptMarketOffer, player->getID(), timestamp, counter, amount);
+	addGameTask(GAME_TASK(playerAcceptMarketOffer), player->getID(), timestamp, counter, amount);
 }
 
 void ProtocolGame::parseModalWindowAnswer(NetworkMessage& msg)
@@ -1238,20 +1289,20 @@ void ProtocolGame::parseModalWindowAnswer(NetworkMessage& msg)
 	uint32_t id = msg.get<uint32_t>();
 	uint8_t button = msg.getByte();
 	uint8_t choice = msg.getByte();
-	addGameTask(&Game::playerAnswerModalWindow, player->getID(), id, button, choice);
+	addGameTask(GAME_TASK(playerAnswerModalWindow), player->getID(), id, button, choice);
 }
 
 void ProtocolGame::parseBrowseField(NetworkMessage& msg)
 {
 	const Position& pos = msg.getPosition();
-	addGameTask(&Game::playerBrowseField, player->getID(), pos);
+	addGameTask(GAME_TASK(playerBrowseField), player->getID(), pos);
 }
 
 void ProtocolGame::parseSeekInContainer(NetworkMessage& msg)
 {
 	uint8_t containerId = msg.getByte();
 	uint16_t index = msg.get<uint16_t>();
-	addGameTask(&Game::playerSeekInContainer, player->getID(), containerId, index);
+	addGameTask(GAME_TASK(playerSeekInContainer), player->getID(), containerId, index);
 }
 
 // Send methods
@@ -1266,10 +1317,7 @@ void ProtocolGame::sendOpenPrivateChannel(const std::string& receiver)
 void ProtocolGame::sendChannelEvent(uint16_t channelId, const std::string& playerName, ChannelEvent_t channelEvent)
 {
 	NetworkMessage msg;
-	msg.addByte(0xF3);
-	msg.add<uint16_t>(channelId);
-	msg.addString(playerName);
-	msg.addByte(channelEvent);
+	AddChannelEvent(msg, channelId, playerName, channelEvent);
 	writeToOutputBuffer(msg);
 }
 
@@ -1408,9 +1456,34 @@ void ProtocolGame::sendReLoginWindow(uint8_t unfairFightReduction)
 
 void ProtocolGame::sendStats()
 {
+	statsChanged = true;
+	if (!playerUpdateScheduled) {
+		playerUpdateScheduled = true;
+		g_dispatcher.addTask(createTask(std::bind(&ProtocolGame::sendPlayerUpdate, getThis())));
+	}
+}
+
+void ProtocolGame::sendPlayerUpdate()
+{
+	playerUpdateScheduled = false;
+	if (!player) {
+		return;
+	}
+
 	NetworkMessage msg;
-	AddPlayerStats(msg);
-	writeToOutputBuffer(msg);
+	if (statsChanged) {
+		statsChanged = false;
+		AddPlayerStatsUpdate(msg);
+	}
+
+	if (skillsChanged) {
+		skillsChanged = false;
+		AddPlayerSkillsUpdate(msg);
+	}
+
+	if (msg.getLength() != 0) {
+		writeToOutputBuffer(msg);
+	}
 }
 
 void ProtocolGame::sendBasicData()
@@ -1435,6 +1508,12 @@ void ProtocolGame::sendBasicData()
 void ProtocolGame::sendTextMessage(const TextMessage& message)
 {
 	NetworkMessage msg;
+	AddTextMessage(msg, message);
+	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::AddTextMessage(NetworkMessage& msg, const TextMessage& message)
+{
 	msg.addByte(0xB4);
 	msg.addByte(message.type);
 	switch (message.type) {
@@ -1467,7 +1546,6 @@ void ProtocolGame::sendTextMessage(const TextMessage& message)
 		}
 	}
 	msg.addString(message.text);
-	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendClosePrivate(uint16_t channelId)
@@ -1505,7 +1583,7 @@ void ProtocolGame::sendChannelsDialog()
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendChannel(uint16_t channelId, const std::string& channelName, const UsersMap* channelUsers, const InvitedMap* invitedUsers)
+void ProtocolGame::sendChannel(uint16_t channelId, const std::string& channelName, const UsersList* channelUsers, const InvitedMap* invitedUsers)
 {
 	NetworkMessage msg;
 	msg.addByte(0xAC);
@@ -1515,8 +1593,8 @@ void ProtocolGame::sendChannel(uint16_t channelId, const std::string& channelNam
 
 	if (channelUsers) {
 		msg.add<uint16_t>(channelUsers->size());
-		for (const auto& it : *channelUsers) {
-			msg.addString(it.second->getName());
+		for (const Player* user : *channelUsers) {
+			msg.addString(user->getName());
 		}
 	} else {
 		msg.add<uint16_t>(0x00);
@@ -1536,13 +1614,7 @@ void ProtocolGame::sendChannel(uint16_t channelId, const std::string& channelNam
 void ProtocolGame::sendChannelMessage(const std::string& author, const std::string& text, SpeakClasses type, uint16_t channel)
 {
 	NetworkMessage msg;
-	msg.addByte(0xAA);
-	msg.add<uint32_t>(0x00);
-	msg.addString(author);
-	msg.add<uint16_t>(0x00);
-	msg.addByte(type);
-	msg.add<uint16_t>(channel);
-	msg.addString(text);
+	AddChannelMessage(msg, author, text, type, channel);
 	writeToOutputBuffer(msg);
 }
 
@@ -2229,34 +2301,19 @@ void ProtocolGame::sendCreatureTurn(const Creature* creature, uint32_t stackPos)
 void ProtocolGame::sendCreatureSay(const Creature* creature, SpeakClasses type, const std::string& text, const Position* pos/* = nullptr*/)
 {
 	NetworkMessage msg;
-	msg.addByte(0xAA);
-
-	static uint32_t statementId = 0;
-	msg.add<uint32_t>(++statementId);
-
-	msg.addString(creature->getName());
-
-	//Add level only for players
-	if (const Player* speaker = creature->getPlayer()) {
-		msg.add<uint16_t>(speaker->getLevel());
-	} else {
-		msg.add<uint16_t>(0x00);
-	}
-
-	msg.addByte(type);
-	if (pos) {
-		msg.addPosition(*pos);
-	} else {
-		msg.addPosition(creature->getPosition());
-	}
-
-	msg.addString(text);
+	AddCreatureSay(msg, creature, type, text, pos);
 	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendToChannel(const Creature* creature, SpeakClasses type, const std::string& text, uint16_t channelId)
 {
 	NetworkMessage msg;
+	AddToChannel(msg, creature, type, text, channelId);
+	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::AddToChannel(NetworkMessage& msg, const Creature* creature, SpeakClasses type, const std::string& text, uint16_t channelId)
+{
 	msg.addByte(0xAA);
 
 	static uint32_t statementId = 0;
@@ -2276,7 +2333,6 @@ void ProtocolGame::sendToChannel(const Creature* creature, SpeakClasses type, co
 	msg.addByte(type);
 	msg.add<uint16_t>(channelId);
 	msg.addString(text);
-	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendPrivateMessage(const Player* speaker, SpeakClasses type, const std::string& text)
@@ -2324,9 +2380,11 @@ void ProtocolGame::sendCancelWalk()
 
 void ProtocolGame::sendSkills()
 {
-	NetworkMessage msg;
-	AddPlayerSkills(msg);
-	writeToOutputBuffer(msg);
+	skillsChanged = true;
+	if (!playerUpdateScheduled) {
+		playerUpdateScheduled = true;
+		g_dispatcher.addTask(createTask(std::bind(&ProtocolGame::sendPlayerUpdate, getThis())));
+	}
 }
 
 void ProtocolGame::sendPing()
@@ -2346,10 +2404,7 @@ void ProtocolGame::sendPingBack()
 void ProtocolGame::sendDistanceShoot(const Position& from, const Position& to, uint8_t type)
 {
 	NetworkMessage msg;
-	msg.addByte(0x85);
-	msg.addPosition(from);
-	msg.addPosition(to);
-	msg.addByte(type);
+	AddDistanceShoot(msg, from, to, type);
 	writeToOutputBuffer(msg);
 }
 
@@ -2360,23 +2415,14 @@ void ProtocolGame::sendMagicEffect(const Position& pos, uint8_t type)
 	}
 
 	NetworkMessage msg;
-	msg.addByte(0x83);
-	msg.addPosition(pos);
-	msg.addByte(type);
+	AddMagicEffect(msg, pos, type);
 	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCreatureHealth(const Creature* creature)
 {
 	NetworkMessage msg;
-	msg.addByte(0x8C);
-	msg.add<uint32_t>(creature->getID());
-
-	if (creature->isHealthHidden()) {
-		msg.addByte(0x00);
-	} else {
-		msg.addByte(std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100));
-	}
+	AddCreatureHealth(msg, creature);
 	writeToOutputBuffer(msg);
 }
 
@@ -2581,8 +2627,11 @@ void ProtocolGame::sendAddCreature(const Creature* creature, const Position& pos
 
 	sendInventoryItem(CONST_SLOT_STORE_INBOX, player->getStoreInbox()->getItem());
 
-	sendStats();
-	sendSkills();
+	// full stats and skills, later changes are sent as updates
+	NetworkMessage playerMsg;
+	AddPlayerStats(playerMsg);
+	AddPlayerSkills(playerMsg);
+	writeToOutputBuffer(playerMsg);
 
 	//gameworld light-settings
 	sendWorldLight(g_game.getWorldLightInfo());
@@ -2933,6 +2982,78 @@ void ProtocolGame::sendModalWindow(const ModalWindow& modalWindow)
 }
 
 ////////////// Add common messages
+void ProtocolGame::AddMagicEffect(NetworkMessage& msg, const Position& pos, uint8_t type)
+{
+	msg.addByte(0x83);
+	msg.addPosition(pos);
+	msg.addByte(type);
+}
+
+void ProtocolGame::AddDistanceShoot(NetworkMessage& msg, const Position& from, const Position& to, uint8_t type)
+{
+	msg.addByte(0x85);
+	msg.addPosition(from);
+	msg.addPosition(to);
+	msg.addByte(type);
+}
+
+void ProtocolGame::AddCreatureHealth(NetworkMessage& msg, const Creature* creature)
+{
+	msg.addByte(0x8C);
+	msg.add<uint32_t>(creature->getID());
+
+	if (creature->isHealthHidden()) {
+		msg.addByte(0x00);
+	} else {
+		msg.addByte(std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100));
+	}
+}
+
+void ProtocolGame::AddCreatureSay(NetworkMessage& msg, const Creature* creature, SpeakClasses type, const std::string& text, const Position* pos/* = nullptr*/)
+{
+	msg.addByte(0xAA);
+
+	static uint32_t statementId = 0;
+	msg.add<uint32_t>(++statementId);
+
+	msg.addString(creature->getName());
+
+	//Add level only for players
+	if (const Player* speaker = creature->getPlayer()) {
+		msg.add<uint16_t>(speaker->getLevel());
+	} else {
+		msg.add<uint16_t>(0x00);
+	}
+
+	msg.addByte(type);
+	if (pos) {
+		msg.addPosition(*pos);
+	} else {
+		msg.addPosition(creature->getPosition());
+	}
+
+	msg.addString(text);
+}
+
+void ProtocolGame::AddChannelMessage(NetworkMessage& msg, const std::string& author, const std::string& text, SpeakClasses type, uint16_t channel)
+{
+	msg.addByte(0xAA);
+	msg.add<uint32_t>(0x00);
+	msg.addString(author);
+	msg.add<uint16_t>(0x00);
+	msg.addByte(type);
+	msg.add<uint16_t>(channel);
+	msg.addString(text);
+}
+
+void ProtocolGame::AddChannelEvent(NetworkMessage& msg, uint16_t channelId, const std::string& playerName, ChannelEvent_t channelEvent)
+{
+	msg.addByte(0xF3);
+	msg.add<uint16_t>(channelId);
+	msg.addString(playerName);
+	msg.addByte(channelEvent);
+}
+
 void ProtocolGame::AddCreature(NetworkMessage& msg, const Creature* creature, bool known, uint32_t remove)
 {
 	CreatureType_t creatureType = creature->getType();
@@ -3005,20 +3126,47 @@ void ProtocolGame::AddCreature(NetworkMessage& msg, const Creature* creature, bo
 	msg.addByte(player->canWalkthroughEx(creature) ? 0x00 : 0x01);
 }
 
+void ProtocolGame::getPlayerStats(PlayerStats& stats) const
+{
+	stats[PLAYERSTAT_HEALTH] = std::min<int32_t>(player->getHealth(), std::numeric_limits<uint16_t>::max());
+	stats[PLAYERSTAT_MAXHEALTH] = std::min<int32_t>(player->getMaxHealth(), std::numeric_limits<uint16_t>::max());
+	stats[PLAYERSTAT_FREECAPACITY] = player->getFreeCapacity();
+	stats[PLAYERSTAT_CAPACITY] = player->getCapacity();
+	stats[PLAYERSTAT_EXPERIENCE] = player->getExperience();
+	stats[PLAYERSTAT_LEVEL] = player->getLevel();
+	stats[PLAYERSTAT_LEVELPERCENT] = player->getLevelPercent();
+	stats[PLAYERSTAT_MANA] = std::min<int32_t>(player->getMana(), std::numeric_limits<uint16_t>::max());
+	stats[PLAYERSTAT_MAXMANA] = std::min<int32_t>(player->getMaxMana(), std::numeric_limits<uint16_t>::max());
+	stats[PLAYERSTAT_MAGICLEVEL] = std::min<uint32_t>(player->getMagicLevel(), std::numeric_limits<uint8_t>::max());
+	stats[PLAYERSTAT_BASEMAGICLEVEL] = std::min<uint32_t>(player->getBaseMagicLevel(), std::numeric_limits<uint8_t>::max());
+	stats[PLAYERSTAT_MAGICLEVELPERCENT] = player->getMagicLevelPercent();
+	stats[PLAYERSTAT_SOUL] = player->getSoul();
+	stats[PLAYERSTAT_STAMINA] = player->getStaminaMinutes();
+	stats[PLAYERSTAT_BASESPEED] = player->getBaseSpeed() / 2;
+
+	Condition* condition = player->getCondition(CONDITION_REGENERATION);
+	stats[PLAYERSTAT_REGENERATION] = condition ? condition->getTicks() / 1000 : 0x00;
+
+	stats[PLAYERSTAT_OFFLINETRAINING] = player->getOfflineTrainingTime() / 60 / 1000;
+}
+
 void ProtocolGame::AddPlayerStats(NetworkMessage& msg)
 {
+	getPlayerStats(sentStats);
+	statsSent = true;
+
 	msg.addByte(0xA0);
 
-	msg.add<uint16_t>(std::min<int32_t>(player->getHealth(), std::numeric_limits<uint16_t>::max()));
-	msg.add<uint16_t>(std::min<int32_t>(player->getMaxHealth(), std::numeric_limits<uint16_t>::max()));
+	msg.add<uint16_t>(sentStats[PLAYERSTAT_HEALTH]);
+	msg.add<uint16_t>(sentStats[PLAYERSTAT_MAXHEALTH]);
 
-	msg.add<uint32_t>(player->getFreeCapacity());
-	msg.add<uint32_t>(player->getCapacity());
+	msg.add<uint32_t>(sentStats[PLAYERSTAT_FREECAPACITY]);
+	msg.add<uint32_t>(sentStats[PLAYERSTAT_CAPACITY]);
 
-	msg.add<uint64_t>(player->getExperience());
+	msg.add<uint64_t>(sentStats[PLAYERSTAT_EXPERIENCE]);
 
-	msg.add<uint16_t>(player->getLevel());
-	msg.addByte(player->getLevelPercent());
+	msg.add<uint16_t>(sentStats[PLAYERSTAT_LEVEL]);
+	msg.addByte(sentStats[PLAYERSTAT_LEVELPERCENT]);
 
 	msg.add<uint16_t>(100); // base xp gain rate
 	msg.add<uint16_t>(0); // xp voucher
@@ -3026,44 +3174,175 @@ void ProtocolGame::AddPlayerStats(NetworkMessage& msg)
 	msg.add<uint16_t>(0); // xp boost
 	msg.add<uint16_t>(100); // stamina multiplier (100 = x1.0)
 
-	msg.add<uint16_t>(std::min<int32_t>(player->getMana(), std::numeric_limits<uint16_t>::max()));
-	msg.add<uint16_t>(std::min<int32_t>(player->getMaxMana(), std::numeric_limits<uint16_t>::max()));
+	msg.add<uint16_t>(sentStats[PLAYERSTAT_MANA]);
+	msg.add<uint16_t>(sentStats[PLAYERSTAT_MAXMANA]);
 
-	msg.addByte(std::min<uint32_t>(player->getMagicLevel(), std::numeric_limits<uint8_t>::max()));
-	msg.addByte(std::min<uint32_t>(player->getBaseMagicLevel(), std::numeric_limits<uint8_t>::max()));
-	msg.addByte(player->getMagicLevelPercent());
+	msg.addByte(sentStats[PLAYERSTAT_MAGICLEVEL]);
+	msg.addByte(sentStats[PLAYERSTAT_BASEMAGICLEVEL]);
+	msg.addByte(sentStats[PLAYERSTAT_MAGICLEVELPERCENT]);
 
-	msg.addByte(player->getSoul());
+	msg.addByte(sentStats[PLAYERSTAT_SOUL]);
 
-	msg.add<uint16_t>(player->getStaminaMinutes());
+	msg.add<uint16_t>(sentStats[PLAYERSTAT_STAMINA]);
 
-	msg.add<uint16_t>(player->getBaseSpeed() / 2);
+	msg.add<uint16_t>(sentStats[PLAYERSTAT_BASESPEED]);
 
-	Condition* condition = player->getCondition(CONDITION_REGENERATION);
-	msg.add<uint16_t>(condition ? condition->getTicks() / 1000 : 0x00);
+	msg.add<uint16_t>(sentStats[PLAYERSTAT_REGENERATION]);
 
-	msg.add<uint16_t>(player->getOfflineTrainingTime() / 60 / 1000);
+	msg.add<uint16_t>(sentStats[PLAYERSTAT_OFFLINETRAINING]);
 
 	msg.add<uint16_t>(0); // xp boost time (seconds)
 	msg.addByte(0); // enables exp boost in the store
 }
 
+void ProtocolGame::AddPlayerStatsUpdate(NetworkMessage& msg)
+{
+	if (!statsSent) {
+		AddPlayerStats(msg);
+		return;
+	}
+
+	PlayerStats stats;
+	getPlayerStats(stats);
+
+	uint8_t changed = 0;
+	for (uint8_t i = 0; i < PLAYERSTAT_COUNT; ++i) {
+		if (stats[i] != sentStats[i]) {
+			++changed;
+		}
+	}
+
+	if (changed == 0) {
+		return;
+	} else if (!playerUpdateDeltas) {
+		AddPlayerStats(msg);
+		return;
+	}
+
+	msg.addByte(0xBA);
+	msg.addByte(changed);
+	for (uint8_t i = 0; i < PLAYERSTAT_COUNT; ++i) {
+		if (stats[i] == sentStats[i]) {
+			continue;
+		}
+
+		msg.addByte(i);
+		switch (i) {
+			case PLAYERSTAT_EXPERIENCE:
+				msg.add<uint64_t>(stats[i]);
+				break;
+
+			case PLAYERSTAT_FREECAPACITY:
+			case PLAYERSTAT_CAPACITY:
+				msg.add<uint32_t>(stats[i]);
+				break;
+
+			case PLAYERSTAT_LEVELPERCENT:
+			case PLAYERSTAT_MAGICLEVEL:
+			case PLAYERSTAT_BASEMAGICLEVEL:
+			case PLAYERSTAT_MAGICLEVELPERCENT:
+			case PLAYERSTAT_SOUL:
+				msg.addByte(stats[i]);
+				break;
+
+			default:
+				msg.add<uint16_t>(stats[i]);
+				break;
+		}
+	}
+
+	sentStats = stats;
+}
+
+void ProtocolGame::getPlayerSkills(PlayerSkills& skills, PlayerSpecialSkills& specialSkills) const
+{
+	for (uint8_t i = SKILL_FIRST; i <= SKILL_LAST; ++i) {
+		SkillInfo& skill = skills[i];
+		skill.level = std::min<int32_t>(player->getSkillLevel(i), std::numeric_limits<uint16_t>::max());
+		skill.base = player->getBaseSkill(i);
+		skill.percent = player->getSkillPercent(i);
+	}
+
+	for (uint8_t i = SPECIALSKILL_FIRST; i <= SPECIALSKILL_LAST; ++i) {
+		specialSkills[i] = std::min<int32_t>(100, player->varSpecialSkills[i]);
+	}
+}
+
 void ProtocolGame::AddPlayerSkills(NetworkMessage& msg)
 {
+	getPlayerSkills(sentSkills, sentSpecialSkills);
+	skillsSent = true;
+
 	msg.addByte(0xA1);
 
 	for (uint8_t i = SKILL_FIRST; i <= SKILL_LAST; ++i) {
-		msg.add<uint16_t>(std::min<int32_t>(player->getSkillLevel(i), std::numeric_limits<uint16_t>::max()));
-		msg.add<uint16_t>(player->getBaseSkill(i));
-		msg.addByte(player->getSkillPercent(i));
+		msg.add<uint16_t>(sentSkills[i].level);
+		msg.add<uint16_t>(sentSkills[i].base);
+		msg.addByte(sentSkills[i].percent);
 	}
 
 	for (uint8_t i = SPECIALSKILL_FIRST; i <= SPECIALSKILL_LAST; ++i) {
-		msg.add<uint16_t>(std::min<int32_t>(100, player->varSpecialSkills[i]));
+		msg.add<uint16_t>(sentSpecialSkills[i]);
 		msg.add<uint16_t>(0);
 	}
 }
 
+void ProtocolGame::AddPlayerSkillsUpdate(NetworkMessage& msg)
+{
+	if (!skillsSent) {
+		AddPlayerSkills(msg);
+		return;
+	}
+
+	PlayerSkills skills;
+	PlayerSpecialSkills specialSkills;
+	getPlayerSkills(skills, specialSkills);
+
+	uint8_t changedSkills = 0;
+	for (uint8_t i = SKILL_FIRST; i <= SKILL_LAST; ++i) {
+		if (skills[i] != sentSkills[i]) {
+			++changedSkills;
+		}
+	}
+
+	uint8_t changedSpecialSkills = 0;
+	for (uint8_t i = SPECIALSKILL_FIRST; i <= SPECIALSKILL_LAST; ++i) {
+		if (specialSkills[i] != sentSpecialSkills[i]) {
+			++changedSpecialSkills;
+		}
+	}
+
+	if (changedSkills == 0 && changedSpecialSkills == 0) {
+		return;
+	} else if (!playerUpdateDeltas) {
+		AddPlayerSkills(msg);
+		return;
+	}
+
+	msg.addByte(0xBB);
+
+	msg.addByte(changedSkills);
+	for (uint8_t i = SKILL_FIRST; i <= SKILL_LAST; ++i) {
+		if (skills[i] != sentSkills[i]) {
+			msg.addByte(i);
+			msg.add<uint16_t>(skills[i].level);
+			msg.add<uint16_t>(skills[i].base);
+			msg.addByte(skills[i].percent);
+		}
+	}
+
+	msg.addByte(changedSpecialSkills);
+	for (uint8_t i = SPECIALSKILL_FIRST; i <= SPECIALSKILL_LAST; ++i) {
+		if (specialSkills[i] != sentSpecialSkills[i]) {
+			msg.addByte(i);
+			msg.add<uint16_t>(specialSkills[i]);
+		}
+	}
+
+	sentSkills = skills;
+	sentSpecialSkills = specialSkills;
+}
+
 void ProtocolGame::AddOutfit(NetworkMessage& msg, const Outfit_t& outfit)
 {
 	msg.add<uint16_t>(outfit.lookType);
@@ -3232,6 +3511,21 @@ void ProtocolGame::parseExtendedOpcode(NetworkMessage& msg)
 	uint8_t opcode = msg.getByte();
 	const std::string& buffer = msg.getString();
 
+	// an otclient sends this opcode after login to opt into compressed messages,
+	// with compression off it is an ordinary opcode for the scripts
+	if (g_config.getNumber(ConfigManager::COMPRESSION_LEVEL) > 0 && opcode == g_config.getNumber(ConfigManager::COMPRESSION_OPCODE)) {
+		// the client inflates every message marked as compressed from now on
+		enableCompression();
+		return;
+	}
+
+	// opts into the 0xBA/0xBB stat and skill deltas, the flag is read by the dispatcher
+	if (g_config.getBoolean(ConfigManager::PLAYER_UPDATE_DELTAS) && opcode == g_config.getNumber(ConfigManager::PLAYER_UPDATE_OPCODE)) {
+		auto thisPtr = getThis();
+		g_dispatcher.addTask(createTask([thisPtr]() { thisPtr->playerUpdateDeltas = true; }));
+		return;
+	}
+
 	// process additional opcodes via lua script event
-	addGameTask(&Game::parsePlayerExtendedOpcode, player->getID(), opcode, buffer);
+	addGameTask(GAME_TASK(parsePlayerExtendedOpcode), player->getID(), opcode, buffer);
 }
@@ -38,6 +38,9 @@ using ProtocolGame_ptr = std::shared_ptr<ProtocolGame>;
 
 extern Game g_game;
 
+// a Game method for addGameTask, preceded by its name which tags the task in lag reports
+#define GAME_TASK(method) "Game::" #method, &Game::method
+
 struct TextMessage
 {
 	MessageClasses type = MESSAGE_STATUS_DEFAULT;
@@ -73,6 +76,16 @@ class ProtocolGame final : public Protocol
 			return version;
 		}
 
+		// viewer independent packets, built once and shared by all spectators
+		static void AddMagicEffect(NetworkMessage& msg, const Position& pos, uint8_t type);
+		static void AddDistanceShoot(NetworkMessage& msg, const Position& from, const Position& to, uint8_t type);
+		static void AddCreatureHealth(NetworkMessage& msg, const Creature* creature);
+		static void AddCreatureSay(NetworkMessage& msg, const Creature* creature, SpeakClasses type, const std::string& text, const Position* pos = nullptr);
+		static void AddToChannel(NetworkMessage& msg, const Creature* creature, SpeakClasses type, const std::string& text, uint16_t channelId);
+		static void AddChannelMessage(NetworkMessage& msg, const std::string& author, const std::string& text, SpeakClasses type, uint16_t channel);
+		static void AddChannelEvent(NetworkMessage& msg, uint16_t channelId, const std::string& playerName, ChannelEvent_t channelEvent);
+		static void AddTextMessage(NetworkMessage& msg, const TextMessage& message);
+
 	private:
 		ProtocolGame_ptr getThis() {
 			return std::static_pointer_cast<ProtocolGame>(shared_from_this());
@@ -92,6 +105,9 @@ class ProtocolGame final : public Protocol
 		// we have all the parse methods
 		void parsePacket(NetworkMessage& msg) override;
 		void onRecvFirstMessage(NetworkMessage& msg) override;
+		bool hasEncryptedFirstMessage() const override {
+			return true;
+		}
 		void onConnect() override;
 
 		//Parse methods
@@ -170,7 +186,7 @@ class ProtocolGame final : public Protocol
 		void sendClosePrivate(uint16_t channelId);
 		void sendCreatePrivateChannel(uint16_t channelId, const std::string& channelName);
 		void sendChannelsDialog();
-		void sendChannel(uint16_t channelId, const std::string& channelName, const UsersMap* channelUsers, const InvitedMap* invitedUsers);
+		void sendChannel(uint16_t channelId, const std::string& channelName, const UsersList* channelUsers, const InvitedMap* invitedUsers);
 		void sendOpenPrivateChannel(const std::string& receiver);
 		void sendToChannel(const Creature* creature, SpeakClasses type, const std::string& text, uint16_t channelId);
 		void sendPrivateMessage(const Player* speaker, SpeakClasses type, const std::string& text);
@@ -194,6 +210,7 @@ class ProtocolGame final : public Protocol
 		void sendCancelTarget();
 		void sendCreatureOutfit(const Creature* creature, const Outfit_t& outfit);
 		void sendStats();
+		void sendPlayerUpdate();
 		void sendBasicData();
 		void sendTextMessage(const TextMessage& message);
 		void sendReLoginWindow(uint8_t unfairFightReduction);
@@ -286,8 +303,10 @@ class ProtocolGame final : public Protocol
 
 		void AddCreature(NetworkMessage& msg, const Creature* creature, bool known, uint32_t remove);
 		void AddPlayerStats(NetworkMessage& msg);
+		void AddPlayerStatsUpdate(NetworkMessage& msg);
 		void AddOutfit(NetworkMessage& msg, const Outfit_t& outfit);
 		void AddPlayerSkills(NetworkMessage& msg);
+		void AddPlayerSkillsUpdate(NetworkMessage& msg);
 		void AddWorldLight(NetworkMessage& msg, LightInfo lightInfo);
 		void AddCreatureLight(NetworkMessage& msg, const Creature* creature);
 
@@ -306,20 +325,68 @@ class ProtocolGame final : public Protocol
 
 		friend class Player;
 
-		// Helpers so we don't need to bind every time
+		// Helpers so we don't need to bind every time, pass GAME_TASK(method) as tag and function
 		template <typename Callable, typename... Args>
-		void addGameTask(Callable&& function, Args&&... args) {
-			g_dispatcher.addTask(createTask(std::bind(std::forward<Callable>(function), &g_game, std::forward<Args>(args)...)));
+		void addGameTask(const char* tag, Callable&& function, Args&&... args) {
+			addPlayerTask(createTask(std::bind(std::forward<Callable>(function), &g_game, std::forward<Args>(args)...)), tag);
 		}
 
 		template <typename Callable, typename... Args>
-		void addGameTaskTimed(uint32_t delay, Callable&& function, Args&&... args) {
-			g_dispatcher.addTask(createTask(delay, std::bind(std::forward<Callable>(function), &g_game, std::forward<Args>(args)...)));
+		void addGameTaskTimed(uint32_t delay, const char* tag, Callable&& function, Args&&... args) {
+			addPlayerTask(createTask(delay, std::bind(std::forward<Callable>(function), &g_game, std::forward<Args>(args)...)), tag);
 		}
 
+		// tags the task with the player and method so a lag report can name who sent what
+		void addPlayerTask(Task* task, const char* tag);
+
+		// fields of the stats update packet, each sent as id followed by its value
+		enum PlayerStat_t : uint8_t {
+			PLAYERSTAT_HEALTH,
+			PLAYERSTAT_MAXHEALTH,
+			PLAYERSTAT_FREECAPACITY,
+			PLAYERSTAT_CAPACITY,
+			PLAYERSTAT_EXPERIENCE,
+			PLAYERSTAT_LEVEL,
+			PLAYERSTAT_LEVELPERCENT,
+			PLAYERSTAT_MANA,
+			PLAYERSTAT_MAXMANA,
+			PLAYERSTAT_MAGICLEVEL,
+			PLAYERSTAT_BASEMAGICLEVEL,
+			PLAYERSTAT_MAGICLEVELPERCENT,
+			PLAYERSTAT_SOUL,
+			PLAYERSTAT_STAMINA,
+			PLAYERSTAT_BASESPEED,
+			PLAYERSTAT_REGENERATION,
+			PLAYERSTAT_OFFLINETRAINING,
+
+			PLAYERSTAT_COUNT
+		};
+
+		struct SkillInfo {
+			uint16_t level = 0;
+			uint16_t base = 0;
+			uint8_t percent = 0;
+
+			bool operator!=(const SkillInfo& other) const {
+				return level != other.level || base != other.base || percent != other.percent;
+			}
+		};
+
+		using PlayerStats = std::array<uint64_t, PLAYERSTAT_COUNT>;
+		using PlayerSkills = std::array<SkillInfo, SKILL_LAST + 1>;
+		using PlayerSpecialSkills = std::array<uint16_t, SPECIALSKILL_LAST + 1>;
+
+		void getPlayerStats(PlayerStats& stats) const;
+		void getPlayerSkills(PlayerSkills& skills, PlayerSpecialSkills& specialSkills) const;
+
 		std::unordered_set<uint32_t> knownCreatureSet;
 		Player* player = nullptr;
 
+		// last values the client received, updates only carry what differs
+		PlayerStats sentStats = {};
+		PlayerSkills sentSkills = {};
+		PlayerSpecialSkills sentSpecialSkills = {};
+
 		uint32_t eventConnect = 0;
 		uint32_t challengeTimestamp = 0;
 		uint16_t version = CLIENT_VERSION_MIN;
@@ -328,6 +395,13 @@ class ProtocolGame final : public Protocol
 
 		bool debugAssertSent = false;
 		bool acceptPackets = false;
+		bool statsSent = false;
+		bool skillsSent = false;
+		bool statsChanged = false;
+		bool skillsChanged = false;
+		bool playerUpdateScheduled = false;
+		// the client asked for the 0xBA/0xBB delta packets, stock clients only know 0xA0/0xA1
+		bool playerUpdateDeltas = false;
 };
 
 #endif
@@ -0,0 +1,62 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "protocolmetrics.h"
+#include "game.h"
+#include "metrics.h"
+#include "outputmessage.h"
+
+extern Game g_game;
+
+// NetworkMessage::addBytes drops larger blocks
+static constexpr size_t METRICS_CHUNK_SIZE = 8192;
+
+void ProtocolMetrics::onConnect()
+{
+	g_metrics.playersOnline.set(g_game.getPlayersOnline());
+	g_metrics.monstersOnline.set(g_game.getMonstersOnline());
+	g_metrics.npcsOnline.set(g_game.getNpcsOnline());
+	g_metrics.activeCreatures.set(g_game.getActiveCreatureCount());
+
+	const std::string body = g_metrics.render();
+
+	std::ostringstream ss;
+	ss << "HTTP/1.0 200 OK\r\n";
+	ss << "Content-Type: text/plain; version=0.0.4\r\n";
+	ss << "Content-Length: " << body.size() << "\r\n";
+	ss << "Connection: close\r\n\r\n";
+	ss << body;
+
+	setRawMessages(true);
+
+	const std::string data = ss.str();
+	for (size_t offset = 0; offset < data.size(); offset += METRICS_CHUNK_SIZE) {
+		const size_t size = std::min<size_t>(data.size() - offset, METRICS_CHUNK_SIZE);
+		auto output = OutputMessagePool::getOutputMessage();
+		output->addBytes(data.c_str() + offset, size);
+		if (output->getLength() != size) {
+			std::cout << "[Error - ProtocolMetrics::onConnect] Could not write " << size << " bytes of the " << data.size() << " byte response." << std::endl;
+			break;
+		}
+		send(output);
+	}
+	disconnect();
+}
@@ -0,0 +1,44 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_PROTOCOLMETRICS_H_7250DBF1FD0F473883DB481CF0DF08AF
+#define FS_PROTOCOLMETRICS_H_7250DBF1FD0F473883DB481CF0DF08AF
+
+#include "protocol.h"
+
+// Answers every connection with the metrics as a plain HTTP response, the
+// request itself is never parsed. The service only listens on 127.0.0.1
+class ProtocolMetrics final : public Protocol
+{
+	public:
+		// static protocol information
+		enum {server_sends_first = true};
+		enum {protocol_identifier = 0}; // Not required as we send first
+		enum {use_checksum = false};
+		static const char* protocol_name() {
+			return "metrics protocol";
+		}
+
+		explicit ProtocolMetrics(Connection_ptr connection) : Protocol(connection) {}
+
+		void onConnect() override;
+		void onRecvFirstMessage(NetworkMessage&) override {}
+};
+
+#endif
@@ -22,6 +22,7 @@
 #include "rsa.h"
 
 #include <cryptopp/base64.h>
+#include <cryptopp/modarith.h>
 #include <cryptopp/osrng.h>
 
 #include <fstream>
@@ -29,11 +30,93 @@
 
 static CryptoPP::AutoSeededRandomPool prng;
 
+// number of decryptions before a thread draws a fresh blinding factor
+static constexpr uint32_t BLINDING_REFRESH_INTERVAL = 32;
+
+struct RSA::Context {
+	const RSA* owner = nullptr;
+	uint32_t keyVersion = 0;
+	uint32_t blindingUses = 0;
+
+	// Montgomery arithmetic keeps a scratch workspace, so every thread owns its own pair
+	std::unique_ptr<CryptoPP::MontgomeryRepresentation> mp, mq;
+
+	// blind = r^e mod n, unblind = r^-1 mod n
+	CryptoPP::Integer blind, unblind;
+
+	CryptoPP::AutoSeededRandomPool rng;
+};
+
+RSA::Context& RSA::getContext() const
+{
+	thread_local Context context;
+
+	uint32_t version = keyVersion.load(std::memory_order_acquire);
+	if (context.owner != this || context.keyVersion != version) {
+		context.owner = this;
+		context.keyVersion = version;
+		context.mp.reset(new CryptoPP::MontgomeryRepresentation(p));
+		context.mq.reset(new CryptoPP::MontgomeryRepresentation(q));
+		context.blindingUses = BLINDING_REFRESH_INTERVAL;
+	}
+
+	if (context.blindingUses++ >= BLINDING_REFRESH_INTERVAL) {
+		CryptoPP::Integer r;
+		do {
+			r.Randomize(context.rng, CryptoPP::Integer::One(), n - CryptoPP::Integer::One());
+			context.unblind = r.InverseMod(n);
+		} while (context.unblind.IsZero());
+		context.blind = a_exp_b_mod_c(r, e, n);
+		context.blindingUses = 1;
+	} else {
+		// squaring both halves keeps them paired: (r^2)^e and (r^2)^-1
+		context.blind = a_times_b_mod_c(context.blind, context.blind, n);
+		context.unblind = a_times_b_mod_c(context.unblind, context.unblind, n);
+	}
+	return context;
+}
+
 void RSA::decrypt(char* msg) const
 {
+	if (keyVersion.load(std::memory_order_acquire) == 0) {
+		std::cout << "[Error - RSA::decrypt] No private key loaded." << std::endl;
+		return;
+	}
+
+	try {
+		Context& context = getContext();
+
+		CryptoPP::Integer c{reinterpret_cast<uint8_t*>(msg), 128};
+		CryptoPP::Integer blinded = a_times_b_mod_c(c, context.blind, n);
+
+		// m = c^d mod n through the two half-size exponentiations, recombined with Garner's formula
+		CryptoPP::Integer mp = context.mp->ConvertOut(context.mp->Exponentiate(context.mp->ConvertIn(blinded % p), dp));
+		CryptoPP::Integer mq = context.mq->ConvertOut(context.mq->Exponentiate(context.mq->ConvertIn(blinded % q), dq));
+		CryptoPP::Integer m = mq + q * ((u * (mp - mq)) % p);
+		m = a_times_b_mod_c(m, context.unblind, n);
+
+		// same fault check as CalculateInverse, a faulty CRT half must not leak the key
+		if (a_exp_b_mod_c(m, e, n) != c) {
+			std::cout << "[Error - RSA::decrypt] Computational error during private key operation." << std::endl;
+			return;
+		}
+
+		m.Encode(reinterpret_cast<uint8_t*>(msg), 128);
+	} catch (const CryptoPP::Exception& e) {
+		std::cout << e.what() << '\n';
+	}
+}
+
+void RSA::encrypt(char* msg) const
+{
+	if (keyVersion.load(std::memory_order_acquire) == 0) {
+		std::cout << "[Error - RSA::encrypt] No key loaded." << std::endl;
+		return;
+	}
+
 	try {
 		CryptoPP::Integer m{reinterpret_cast<uint8_t*>(msg), 128};
-		auto c = pk.CalculateInverse(prng, m);
+		CryptoPP::Integer c = a_exp_b_mod_c(m, e, n);
 		c.Encode(reinterpret_cast<uint8_t*>(msg), 128);
 	} catch (const CryptoPP::Exception& e) {
 		std::cout << e.what() << '\n';
@@ -77,6 +160,15 @@ void RSA::loadPEM(const std::string& filename)
 		if (!pk.Validate(prng, 3)) {
 			throw std::runtime_error("RSA private key is not valid.");
 		}
+
+		n = pk.GetModulus();
+		e = pk.GetPublicExponent();
+		p = pk.GetPrime1();
+		q = pk.GetPrime2();
+		dp = pk.GetModPrime1PrivateExponent();
+		dq = pk.GetModPrime2PrivateExponent();
+		u = pk.GetMultiplicativeInverseOfPrime2ModPrime1();
+		keyVersion.fetch_add(1, std::memory_order_release);
 	} catch (const CryptoPP::Exception& e) {
 		std::cout << e.what() << '\n';
 	}
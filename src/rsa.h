@@ -22,6 +22,7 @@
 
 #include <cryptopp/rsa.h>
 
+#include <atomic>
 #include <string>
 
 class RSA
@@ -35,9 +36,25 @@ class RSA
 
 		void loadPEM(const std::string& filename);
 		void decrypt(char* msg) const;
+		// public key operation, used by clients that share the server key
+		void encrypt(char* msg) const;
+
+		// reference for tfs_rsacheck, which compares decrypt against CalculateInverse
+		const CryptoPP::RSA::PrivateKey& getPrivateKey() const {
+			return pk;
+		}
 
 	private:
+		struct Context;
+
+		// per-thread Montgomery contexts and blinding factors, rebuilt whenever the key changes
+		Context& getContext() const;
+
 		CryptoPP::RSA::PrivateKey pk;
+
+		// CRT parameters cached from pk, u = q^-1 mod p
+		CryptoPP::Integer n, e, p, q, dp, dq, u;
+		std::atomic<uint32_t> keyVersion{0};
 };
 
 #endif
@@ -20,9 +20,16 @@
 #include "otpch.h"
 
 #include "scheduler.h"
+#include "tools.h"
 #include <boost/asio/post.hpp>
 #include <memory>
 
+// defined next to the scheduler so a build with a different event loop can supply its own clock
+int64_t OTSYS_TIME()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 uint32_t Scheduler::addEvent(SchedulerTask* task)
 {
 	// check if the event has a valid id
@@ -21,6 +21,7 @@
 #define FS_SERVER_H_984DA68ABF744127850F90CC710F281B
 
 #include "connection.h"
+#include "metrics.h"
 #include "signals.h"
 #include <memory>
 
@@ -55,14 +56,19 @@ class Service final : public ServiceBase
 		}
 
 		Protocol_ptr make_protocol(const Connection_ptr& c) const override {
-			return std::make_shared<ProtocolType>(c);
+			auto protocol = std::make_shared<ProtocolType>(c);
+			protocol->setTraffic(&traffic);
+			return protocol;
 		}
+
+	private:
+		ProtocolTraffic& traffic = g_metrics.getProtocolTraffic(ProtocolType::protocol_name());
 };
 
 class ServicePort : public std::enable_shared_from_this<ServicePort>
 {
 	public:
-		explicit ServicePort(boost::asio::io_service& io_service) : io_service(io_service) {}
+		ServicePort(boost::asio::io_service& io_service, bool loopbackOnly) : io_service(io_service), loopbackOnly(loopbackOnly) {}
 		~ServicePort();
 
 		// non-copyable
@@ -90,6 +96,7 @@ class ServicePort : public std::enable_shared_from_this<ServicePort>
 
 		uint16_t serverPort = 0;
 		bool pendingStart = false;
+		bool loopbackOnly;
 };
 
 class ServiceManager
@@ -105,8 +112,9 @@ class ServiceManager
 		void run();
 		void stop();
 
+		// a loopback only service binds to 127.0.0.1 instead of the configured address
 		template <typename ProtocolType>
-		bool add(uint16_t port);
+		bool add(uint16_t port, bool loopbackOnly = false);
 
 		bool is_running() const {
 			return acceptors.empty() == false;
@@ -124,7 +132,7 @@ class ServiceManager
 };
 
 template <typename ProtocolType>
-bool ServiceManager::add(uint16_t port)
+bool ServiceManager::add(uint16_t port, bool loopbackOnly/* = false*/)
 {
 	if (port == 0) {
 		std::cout << "ERROR: No port provided for service " << ProtocolType::protocol_name() << ". Service disabled." << std::endl;
@@ -136,7 +144,7 @@ bool ServiceManager::add(uint16_t port)
 	auto foundServicePort = acceptors.find(port);
 
 	if (foundServicePort == acceptors.end()) {
-		service_port = std::make_shared<ServicePort>(io_service);
+		service_port = std::make_shared<ServicePort>(io_service, loopbackOnly);
 		service_port->open(port);
 		acceptors[port] = service_port;
 	} else {
@@ -37,6 +37,7 @@
 #include "events.h"
 #include "scheduler.h"
 #include "databasetasks.h"
+#include "objectpool.h"
 
 extern Scheduler g_scheduler;
 extern DatabaseTasks g_databaseTasks;
@@ -79,6 +80,13 @@ void sigusr1Handler()
 	g_game.saveGameState();
 }
 
+void sigusr2Handler()
+{
+	//Dispatcher thread
+	std::cout << "SIGUSR2 received, dumping allocation statistics..." << std::endl;
+	dumpAllocationStats();
+}
+
 void sighupHandler()
 {
 	//Dispatcher thread
@@ -166,6 +174,9 @@ void dispatchSignalHandler(int signal)
 		case SIGUSR1: //Saves game state
 			g_dispatcher.addTask(createTask(sigusr1Handler));
 			break;
+		case SIGUSR2: //Dumps allocation statistics
+			g_dispatcher.addTask(createTask(sigusr2Handler));
+			break;
 #else
 		case SIGBREAK: //Shuts the server down
 			g_dispatcher.addTask(createTask(sigbreakHandler));
@@ -188,6 +199,7 @@ Signals::Signals(boost::asio::io_service& service): set(service)
 	set.add(SIGTERM);
 #ifndef _WIN32
 	set.add(SIGUSR1);
+	set.add(SIGUSR2);
 	set.add(SIGHUP);
 #else
 	// This must be a blocking call as Windows calls it in a new thread and terminates
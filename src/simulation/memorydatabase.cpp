@@ -0,0 +1,262 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "simulation/memorydatabase.h"
+#include "database.h"
+#include "metrics.h"
+
+#include <cstring>
+
+namespace {
+
+// results stay alive until exit since DBResult only keeps pointers into them
+struct StoredResult
+{
+	std::vector<std::string> values;
+	std::vector<char*> fields;
+	std::map<std::string, size_t> names;
+};
+
+std::map<uint32_t, simulation::DatabaseRow> playersById;
+std::map<std::string, uint32_t> playerIdsByName;
+std::map<std::string, StoredResult> storedResults;
+
+// "SELECT `p`.`id`, `name` FROM ..." gives id and name
+std::vector<std::string> parseColumns(const std::string& query)
+{
+	std::vector<std::string> columns;
+
+	size_t end = query.find(" FROM ");
+	if (query.compare(0, 7, "SELECT ") != 0 || end == std::string::npos) {
+		return columns;
+	}
+
+	std::istringstream ss(query.substr(7, end - 7));
+	std::string column;
+	while (std::getline(ss, column, ',')) {
+		size_t last = column.rfind('`');
+		size_t first = last == std::string::npos || last == 0 ? std::string::npos : column.rfind('`', last - 1);
+		if (first != std::string::npos) {
+			columns.push_back(column.substr(first + 1, last - first - 1));
+		}
+	}
+	return columns;
+}
+
+// reads the value compared against the given column, quoted or not
+bool parseCondition(const std::string& query, const std::string& column, std::string& value)
+{
+	const std::string needle = "`" + column + "` = ";
+	size_t pos = query.find(needle);
+	if (pos == std::string::npos) {
+		return false;
+	}
+
+	pos += needle.length();
+	value.clear();
+	if (pos < query.length() && query[pos] == '\'') {
+		for (++pos; pos < query.length() && query[pos] != '\''; ++pos) {
+			if (query[pos] == '\\' && pos + 1 < query.length()) {
+				++pos;
+			}
+			value.push_back(query[pos]);
+		}
+	} else {
+		while (pos < query.length() && std::isdigit(static_cast<unsigned char>(query[pos]))) {
+			value.push_back(query[pos++]);
+		}
+	}
+	return !value.empty();
+}
+
+const simulation::DatabaseRow* findPlayer(const std::string& query)
+{
+	std::string value;
+	if (parseCondition(query, "id", value)) {
+		auto it = playersById.find(std::stoul(value));
+		return it != playersById.end() ? &it->second : nullptr;
+	} else if (parseCondition(query, "name", value)) {
+		auto it = playerIdsByName.find(value);
+		return it != playerIdsByName.end() ? &playersById[it->second] : nullptr;
+	}
+	return nullptr;
+}
+
+}
+
+namespace simulation {
+
+void addPlayerRow(DatabaseRow row)
+{
+	uint32_t id = std::stoul(row["id"]);
+	playerIdsByName[row["name"]] = id;
+	playersById[id] = std::move(row);
+}
+
+}
+
+Database::~Database() = default;
+
+bool Database::connect()
+{
+	return true;
+}
+
+bool Database::beginTransaction()
+{
+	databaseLock.lock();
+	return true;
+}
+
+bool Database::rollback()
+{
+	databaseLock.unlock();
+	return true;
+}
+
+bool Database::commit()
+{
+	databaseLock.unlock();
+	return true;
+}
+
+bool Database::executeQuery(const std::string&)
+{
+	return true;
+}
+
+DBResult_ptr Database::storeQuery(const std::string& query)
+{
+	MetricTimer timer(g_metrics.databaseQuery);
+
+	std::lock_guard<std::recursive_mutex> lockGuard(databaseLock);
+
+	if (query.find(" FROM `players`") == std::string::npos) {
+		return nullptr;
+	}
+
+	const simulation::DatabaseRow* row = findPlayer(query);
+	if (!row) {
+		return nullptr;
+	}
+
+	StoredResult& stored = storedResults[query];
+	if (stored.fields.empty()) {
+		for (const std::string& column : parseColumns(query)) {
+			auto it = row->find(column);
+			stored.names[column] = stored.values.size();
+			stored.values.push_back(it != row->end() ? it->second : "0");
+		}
+
+		if (stored.values.empty()) {
+			return nullptr;
+		}
+
+		for (std::string& value : stored.values) {
+			stored.fields.push_back(&value[0]);
+		}
+	}
+
+	DBResult_ptr result = std::make_shared<DBResult>(nullptr);
+	result->row = stored.fields.data();
+	result->listNames = stored.names;
+	return result;
+}
+
+std::string Database::escapeString(const std::string& s) const
+{
+	return escapeBlob(s.c_str(), s.length());
+}
+
+std::string Database::escapeBlob(const char* s, uint32_t length) const
+{
+	std::string escaped;
+	escaped.reserve(length + 2);
+	escaped.push_back('\'');
+	for (uint32_t i = 0; i < length; ++i) {
+		if (s[i] == '\'' || s[i] == '\\') {
+			escaped.push_back('\\');
+		}
+		escaped.push_back(s[i]);
+	}
+	escaped.push_back('\'');
+	return escaped;
+}
+
+DBResult::DBResult(MYSQL_RES* res) : handle(res), row(nullptr) {}
+
+DBResult::~DBResult() = default;
+
+std::string DBResult::getString(const std::string& s) const
+{
+	auto it = listNames.find(s);
+	if (it == listNames.end()) {
+		std::cout << "[Error - DBResult::getString] Column '" << s << "' does not exist in result set." << std::endl;
+		return std::string();
+	}
+	return std::string(row[it->second]);
+}
+
+const char* DBResult::getStream(const std::string& s, unsigned long long& size) const
+{
+	auto it = listNames.find(s);
+	if (it == listNames.end()) {
+		std::cout << "[Error - DBResult::getStream] Column '" << s << "' doesn't exist in the result set" << std::endl;
+		size = 0;
+		return nullptr;
+	}
+
+	size = std::strlen(row[it->second]);
+	return row[it->second];
+}
+
+bool DBResult::hasNext() const
+{
+	return row != nullptr;
+}
+
+bool DBResult::next()
+{
+	// every stored result has a single row
+	row = nullptr;
+	return false;
+}
+
+DBInsert::DBInsert(std::string query) : query(std::move(query))
+{
+	this->length = this->query.length();
+}
+
+bool DBInsert::addRow(const std::string&)
+{
+	return true;
+}
+
+bool DBInsert::addRow(std::ostringstream& row)
+{
+	row.str(std::string());
+	return true;
+}
+
+bool DBInsert::execute()
+{
+	return true;
+}
@@ -0,0 +1,36 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_MEMORYDATABASE_H_EF5BE9ED23A244BDBAB1E502C4B6D212
+#define FS_MEMORYDATABASE_H_EF5BE9ED23A244BDBAB1E502C4B6D212
+
+// The simulation build links memorydatabase.cpp instead of database.cpp.
+// Queries on the players table are answered from rows added here, columns a
+// row does not set read as 0, every other query finds nothing and every
+// write succeeds without being stored.
+namespace simulation {
+
+using DatabaseRow = std::map<std::string, std::string>;
+
+// the row needs at least the id and name columns
+void addPlayerRow(DatabaseRow row);
+
+}
+
+#endif
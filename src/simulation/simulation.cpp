@@ -0,0 +1,572 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "simulation/memorydatabase.h"
+#include "simulation/virtualclock.h"
+
+#include "configmanager.h"
+#include "cryptotasks.h"
+#include "databasetasks.h"
+#include "game.h"
+#include "luascript.h"
+#include "lagwatchdog.h"
+#include "metrics.h"
+#include "monster.h"
+#include "monsters.h"
+#include "outfit.h"
+#include "protocolgame.h"
+#include "rsa.h"
+#include "scheduler.h"
+#include "scriptmanager.h"
+#include "script.h"
+#include "tracing.h"
+#include "workerpool.h"
+
+#include <fstream>
+
+// the globals otserv.cpp defines for the server build
+Metrics g_metrics;
+Tracer g_tracer;
+DatabaseTasks g_databaseTasks;
+CryptoTasks g_cryptoTasks;
+LagWatchdog g_lagWatchdog;
+WorkerPool g_workerPool;
+Dispatcher g_dispatcher;
+Scheduler g_scheduler;
+
+Game g_game;
+ConfigManager g_config;
+Monsters g_monsters;
+Vocations g_vocations;
+extern Scripts* g_scripts;
+RSA g_RSA;
+
+extern LuaEnvironment g_luaEnvironment;
+
+namespace {
+
+struct SimulationOptions
+{
+	uint32_t players = 100;
+	uint32_t duration = 600;
+	uint32_t step = 50;
+	uint32_t actionInterval = 1000;
+	uint32_t attackWeight = 1;
+	uint32_t walkWeight = 3;
+	uint32_t spread = 30;
+	uint32_t level = 50;
+	uint16_t vocation = 4;
+	uint32_t townId = 1;
+	uint64_t seed = 1;
+	uint32_t workerThreads = 0;
+};
+
+struct SimulatedPlayer
+{
+	std::string name;
+	uint32_t guid = 0;
+	uint32_t playerId = 0;
+	int64_t nextAction = 0;
+	uint32_t logins = 0;
+};
+
+bool parseArgument(const std::string& arg, SimulationOptions& options)
+{
+	auto separator = arg.find('=');
+	if (arg.compare(0, 2, "--") != 0 || separator == std::string::npos) {
+		return false;
+	}
+
+	const std::string name = arg.substr(2, separator - 2);
+	const std::string value = arg.substr(separator + 1);
+	try {
+		if (name == "config") {
+			g_config.setString(ConfigManager::CONFIG_FILE, value);
+		} else if (name == "players") {
+			options.players = std::stoul(value);
+		} else if (name == "duration") {
+			options.duration = std::stoul(value);
+		} else if (name == "step") {
+			options.step = std::max<uint32_t>(1, std::stoul(value));
+		} else if (name == "action-interval") {
+			options.actionInterval = std::max<uint32_t>(1, std::stoul(value));
+		} else if (name == "attack") {
+			options.attackWeight = std::stoul(value);
+		} else if (name == "walk") {
+			options.walkWeight = std::stoul(value);
+		} else if (name == "spread") {
+			options.spread = std::stoul(value);
+		} else if (name == "level") {
+			options.level = std::max<uint32_t>(1, std::stoul(value));
+		} else if (name == "vocation") {
+			options.vocation = static_cast<uint16_t>(std::stoul(value));
+		} else if (name == "town") {
+			options.townId = std::stoul(value);
+		} else if (name == "seed") {
+			options.seed = std::stoull(value);
+		} else if (name == "worker-threads") {
+			options.workerThreads = std::stoul(value);
+		} else {
+			return false;
+		}
+	} catch (const std::exception&) {
+		return false;
+	}
+	return true;
+}
+
+void printUsage()
+{
+	std::cout << "Usage: tfs_simulation [options]\n"
+		"\n"
+		"\t--config=$1\t\tConfiguration file, the map and data directory are read from it.\n"
+		"\t--players=$1\t\tSynthetic players to log in (100).\n"
+		"\t--duration=$1\t\tVirtual seconds to simulate (600).\n"
+		"\t--step=$1\t\tVirtual milliseconds between driver rounds (50).\n"
+		"\t--action-interval=$1\tVirtual milliseconds between actions of a player (1000).\n"
+		"\t--walk=$1 --attack=$1\tRelative weights of the actions (3, 1).\n"
+		"\t--spread=$1\t\tPlayers log in up to this many tiles from the temple (30).\n"
+		"\t--level=$1 --vocation=$1\tCharacter level and vocation id (50, 4).\n"
+		"\t--town=$1\t\tTown the characters belong to (1).\n"
+		"\t--seed=$1\t\tRandom seed, runs with the same seed take the same decisions (1).\n"
+		"\t--worker-threads=$1\tWorker pool threads for creature ticks, runs with workers are not deterministic (0).\n";
+}
+
+bool loadWorld()
+{
+	std::cout << ">> Loading config" << std::endl;
+	if (!g_config.load()) {
+		std::cout << "> ERROR: Unable to load " << g_config.getString(ConfigManager::CONFIG_FILE) << '!' << std::endl;
+		return false;
+	}
+
+	std::cout << ">> Loading vocations" << std::endl;
+	if (!g_vocations.loadFromXml()) {
+		std::cout << "> ERROR: Unable to load vocations!" << std::endl;
+		return false;
+	}
+
+	std::cout << ">> Loading items" << std::endl;
+	if (!Item::items.loadFromOtb("data/items/items.otb") || !Item::items.loadFromXml()) {
+		std::cout << "> ERROR: Unable to load items!" << std::endl;
+		return false;
+	}
+
+	std::cout << ">> Loading script systems" << std::endl;
+	if (!ScriptingManager::getInstance().loadScriptSystems() || !g_scripts->loadScripts("scripts", false, false)) {
+		std::cout << "> ERROR: Failed to load script systems" << std::endl;
+		return false;
+	}
+
+	std::cout << ">> Loading monsters" << std::endl;
+	if (!g_monsters.loadFromXml() || !g_scripts->loadScripts("monster", false, false)) {
+		std::cout << "> ERROR: Unable to load monsters!" << std::endl;
+		return false;
+	}
+
+	std::cout << ">> Loading outfits" << std::endl;
+	if (!Outfits::getInstance().loadFromXml()) {
+		std::cout << "> ERROR: Unable to load outfits!" << std::endl;
+		return false;
+	}
+
+	std::string worldType = asLowerCaseString(g_config.getString(ConfigManager::WORLD_TYPE));
+	if (worldType == "no-pvp") {
+		g_game.setWorldType(WORLD_TYPE_NO_PVP);
+	} else if (worldType == "pvp-enforced") {
+		g_game.setWorldType(WORLD_TYPE_PVP_ENFORCED);
+	} else {
+		g_game.setWorldType(WORLD_TYPE_PVP);
+	}
+
+	std::cout << ">> Loading map" << std::endl;
+	if (!g_game.loadMainMap(g_config.getString(ConfigManager::MAP_NAME))) {
+		std::cout << "> ERROR: Failed to load map" << std::endl;
+		return false;
+	}
+
+	g_game.setGameState(GAME_STATE_INIT);
+	return true;
+}
+
+// os.time() without a date table reads the virtual clock
+int luaVirtualOsTime(lua_State* L)
+{
+	if (lua_gettop(L) == 0 || lua_isnil(L, 1)) {
+		lua_pushnumber(L, OTSYS_TIME() / 1000);
+		return 1;
+	}
+
+	lua_pushvalue(L, lua_upvalueindex(1));
+	lua_insert(L, 1);
+	lua_call(L, lua_gettop(L) - 1, 1);
+	return 1;
+}
+
+// global.lua seeds math.random from the wall clock, scripts roll spell formulas and loot with it
+void seedScripts(uint64_t seed)
+{
+	lua_State* L = g_luaEnvironment.getLuaState();
+
+	lua_getglobal(L, "math");
+	lua_getfield(L, -1, "randomseed");
+	lua_pushnumber(L, static_cast<uint32_t>(seed));
+	lua_call(L, 1, 0);
+	lua_pop(L, 1);
+
+	lua_getglobal(L, "os");
+	lua_getfield(L, -1, "time");
+	lua_pushcclosure(L, luaVirtualOsTime, 1);
+	lua_setfield(L, -2, "time");
+	lua_pop(L, 1);
+}
+
+// FNV-1a over the state of every player and monster, runs that took the same decisions print the same digest
+uint64_t worldDigest()
+{
+	uint64_t digest = 0xCBF29CE484222325;
+	auto mix = [&digest](uint64_t value) {
+		for (int i = 0; i < 8; ++i) {
+			digest = (digest ^ ((value >> (i * 8)) & 0xFF)) * 0x100000001B3;
+		}
+	};
+	auto mixCreature = [&mix](const Creature* creature) {
+		const Position& pos = creature->getPosition();
+		mix(creature->getID());
+		mix((static_cast<uint64_t>(pos.x) << 24) | (static_cast<uint64_t>(pos.y) << 8) | pos.z);
+		mix(static_cast<uint32_t>(creature->getHealth()));
+	};
+
+	std::vector<const Player*> players;
+	for (const auto& it : g_game.getPlayers()) {
+		players.push_back(it.second);
+	}
+	std::sort(players.begin(), players.end(), [](const Player* lhs, const Player* rhs) { return lhs->getID() < rhs->getID(); });
+	for (const Player* player : players) {
+		mixCreature(player);
+		mix(player->getExperience());
+		mix(static_cast<uint32_t>(player->getMana()));
+	}
+
+	for (const auto& it : g_game.getMonsters()) {
+		mixCreature(it.second);
+	}
+	return digest;
+}
+
+void addPlayerRows(const SimulationOptions& options, const Vocation& vocation, const Position& temple, std::vector<SimulatedPlayer>& players)
+{
+	const uint64_t experience = Player::getExpForLevel(options.level);
+	const uint32_t health = 150 + vocation.getHPGain() * (options.level - 1);
+	const uint32_t mana = vocation.getManaGain() * (options.level - 1);
+	const uint32_t capacity = 400 + vocation.getCapGain() * (options.level - 1);
+	const int32_t spread = static_cast<int32_t>(options.spread);
+	for (uint32_t i = 0; i < options.players; ++i) {
+		SimulatedPlayer simulated;
+		simulated.guid = i + 1;
+		simulated.name = "Sim " + std::to_string(simulated.guid);
+
+		// login falls back to the temple when the tile is not walkable
+		Position position = temple;
+		position.x += uniform_random(-spread, spread);
+		position.y += uniform_random(-spread, spread);
+
+		simulation::addPlayerRow({
+			{"id", std::to_string(simulated.guid)},
+			{"name", simulated.name},
+			{"account_id", std::to_string(simulated.guid)},
+			{"group_id", "1"},
+			{"vocation", std::to_string(options.vocation)},
+			{"level", std::to_string(options.level)},
+			{"experience", std::to_string(experience)},
+			{"health", std::to_string(health)},
+			{"healthmax", std::to_string(health)},
+			{"mana", std::to_string(mana)},
+			{"manamax", std::to_string(mana)},
+			{"cap", std::to_string(capacity)},
+			{"looktype", "128"},
+			{"direction", "2"},
+			{"town_id", std::to_string(options.townId)},
+			{"posx", std::to_string(position.x)},
+			{"posy", std::to_string(position.y)},
+			{"posz", std::to_string(position.z)},
+			{"conditions", ""},
+			{"stamina", "2520"},
+			{"offlinetraining_skill", "-1"},
+			{"skill_fist", "10"},
+			{"skill_club", "10"},
+			{"skill_sword", "10"},
+			{"skill_axe", "10"},
+			{"skill_dist", "10"},
+			{"skill_shielding", "10"},
+			{"skill_fishing", "10"},
+		});
+
+		simulated.nextAction = simulation::getTime() + uniform_random(0, options.actionInterval);
+		players.push_back(std::move(simulated));
+	}
+}
+
+// logs in through a game protocol without a connection, everything it sends is encoded and dropped
+void login(SimulatedPlayer& simulated)
+{
+	auto client = std::make_shared<ProtocolGame>(nullptr);
+	client->login(simulated.name, simulated.guid, CLIENTOS_WINDOWS);
+
+	Player* player = g_game.getPlayerByName(simulated.name);
+	simulated.playerId = player ? player->getID() : 0;
+	++simulated.logins;
+}
+
+Creature* findNearestMonster(Player* player)
+{
+	const Position& position = player->getPosition();
+
+	SpectatorVec spectators;
+	g_game.map.getSpectators(spectators, position, false, false, Map::maxClientViewportX, Map::maxClientViewportX, Map::maxClientViewportY, Map::maxClientViewportY);
+
+	Creature* nearest = nullptr;
+	int32_t nearestDistance = std::numeric_limits<int32_t>::max();
+	for (Creature* creature : spectators) {
+		if (!creature->getMonster() || creature->isRemoved()) {
+			continue;
+		}
+
+		const Position& targetPosition = creature->getPosition();
+		int32_t distance = std::max(Position::getDistanceX(position, targetPosition), Position::getDistanceY(position, targetPosition));
+		if (distance < nearestDistance) {
+			nearest = creature;
+			nearestDistance = distance;
+		}
+	}
+	return nearest;
+}
+
+void act(SimulatedPlayer& simulated, const SimulationOptions& options)
+{
+	Player* player = g_game.getPlayerByID(simulated.playerId);
+	if (!player) {
+		// died or was kicked, a real client would log in again
+		login(simulated);
+		return;
+	}
+
+	g_game.playerReceivePing(simulated.playerId);
+
+	const uint32_t weights = options.walkWeight + options.attackWeight;
+	if (weights == 0) {
+		return;
+	}
+
+	if (static_cast<uint32_t>(uniform_random(1, weights)) > options.walkWeight) {
+		Creature* target = player->getAttackedCreature();
+		if (!target || target->isRemoved()) {
+			target = findNearestMonster(player);
+		}
+
+		if (target) {
+			g_game.playerSetAttackedCreature(simulated.playerId, target->getID());
+			return;
+		}
+	}
+
+	g_game.playerMove(simulated.playerId, static_cast<Direction>(uniform_random(DIRECTION_NORTH, DIRECTION_WEST)));
+}
+
+struct Subsystem
+{
+	const char* name;
+	const MetricHistogram& histogram;
+};
+
+// upper bound of the bucket holding the given quantile
+std::string quantile(const MetricHistogram& histogram, uint64_t count, double q)
+{
+	uint64_t cumulative = 0;
+	for (size_t i = 0; i < MetricHistogram::bounds.size(); ++i) {
+		cumulative += histogram.getBucket(i);
+		if (cumulative >= q * count) {
+			return "<=" + std::to_string(MetricHistogram::bounds[i]);
+		}
+	}
+	return ">" + std::to_string(MetricHistogram::bounds.back());
+}
+
+void printReport(const SimulationOptions& options, double wallSeconds)
+{
+	std::cout << std::endl << ">> Simulated " << options.duration << " s with " << g_game.getPlayersOnline() << " players and "
+		<< g_game.getMonstersOnline() << " monsters in " << std::fixed << std::setprecision(2) << wallSeconds << " s ("
+		<< (wallSeconds > 0 ? options.duration / wallSeconds : 0) << "x real time)" << std::endl;
+	std::cout << "world digest: " << std::hex << std::setw(16) << std::setfill('0') << worldDigest() << std::dec << std::setfill(' ') << std::endl;
+	if (options.workerThreads != 0) {
+		std::cout << "Ran with " << options.workerThreads << " worker threads, the results of this seed are not deterministic." << std::endl;
+	}
+	std::cout << std::endl;
+
+	const Subsystem subsystems[] = {
+		{"dispatcher tasks", g_metrics.dispatcherTaskRun},
+		{"checkCreatures", g_metrics.checkCreaturesTick},
+		{"decay", g_metrics.decayTick},
+		{"spawns", g_metrics.spawnCheck},
+		{"target combat", g_metrics.targetCombat},
+		{"area combat", g_metrics.areaCombat},
+		{"pathfinding", g_metrics.pathSearch},
+	};
+
+	std::cout << std::left << std::setw(18) << "subsystem" << std::right << std::setw(10) << "calls" << std::setw(12) << "total ms"
+		<< std::setw(10) << "mean us" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::endl;
+	for (const Subsystem& subsystem : subsystems) {
+		uint64_t count = 0;
+		for (size_t i = 0; i <= MetricHistogram::bounds.size(); ++i) {
+			count += subsystem.histogram.getBucket(i);
+		}
+
+		const uint64_t sum = subsystem.histogram.getSum();
+		std::cout << std::left << std::setw(18) << subsystem.name << std::right << std::setw(10) << count
+			<< std::setw(12) << std::setprecision(1) << sum / 1000. << std::setw(10) << (count != 0 ? sum / count : 0)
+			<< std::setw(10) << (count != 0 ? quantile(subsystem.histogram, count, 0.5) : "-")
+			<< std::setw(10) << (count != 0 ? quantile(subsystem.histogram, count, 0.99) : "-") << std::endl;
+	}
+
+	std::cout << std::endl << "path searches: " << g_metrics.pathSearches.get() << ", nodes expanded: " << g_metrics.pathNodesExpanded.get() << std::endl;
+	std::cout << "spectator queries: " << g_metrics.spectatorQueries.get() << ", cache hits: " << g_metrics.spectatorCacheHits.get() << std::endl;
+}
+
+// resident set from /proc/self/status where there is one, and the slabs the object pools hold
+void printMemory(const char* when)
+{
+	uint64_t slabs = 0, releasedSlabs = 0;
+	for (const SlabAllocator* allocator : {&getItemAllocator(), &getMonsterAllocator(), &getConditionAllocator()}) {
+		for (const SlabAllocator::SizeClassStats& stats : allocator->getStats()) {
+			slabs += stats.slabs;
+		}
+		releasedSlabs += allocator->getReleasedSlabs();
+	}
+
+	std::cout << "memory " << when << ": ";
+
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line)) {
+		if (line.compare(0, 6, "VmRSS:") == 0) {
+			std::cout << "rss " << std::stoul(line.substr(6)) << " KiB, ";
+		} else if (line.compare(0, 6, "VmHWM:") == 0) {
+			std::cout << "peak rss " << std::stoul(line.substr(6)) << " KiB, ";
+		}
+	}
+
+	std::cout << "pool slabs " << slabs << " (" << slabs * SlabAllocator::SLAB_SIZE / 1024 << " KiB), " << releasedSlabs << " released" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	SimulationOptions options;
+	for (int i = 1; i < argc; ++i) {
+		if (!parseArgument(argv[i], options)) {
+			std::cout << "Unknown or invalid argument " << argv[i] << '.' << std::endl;
+			printUsage();
+			return 1;
+		}
+	}
+
+	// without workers everything runs on this thread, a seed then fixes every decision of the run
+	seedRandomGenerator(options.seed);
+	srand(static_cast<unsigned int>(options.seed));
+
+	g_game.setGameState(GAME_STATE_STARTUP);
+	if (!loadWorld()) {
+		return 1;
+	}
+	seedScripts(options.seed);
+
+	Town* town = g_game.map.towns.getTown(options.townId);
+	if (!town) {
+		std::cout << "> ERROR: Town " << options.townId << " does not exist on this map." << std::endl;
+		return 1;
+	}
+
+	Vocation* vocation = g_vocations.getVocation(options.vocation);
+	if (!vocation) {
+		std::cout << "> ERROR: Vocation " << options.vocation << " does not exist." << std::endl;
+		return 1;
+	}
+
+	if (options.workerThreads != 0) {
+		// workers draw from their own unseeded generators and finish in any order
+		std::cout << ">> Starting " << options.workerThreads << " worker threads, this run is not deterministic" << std::endl;
+		g_workerPool.start(options.workerThreads);
+	}
+
+	g_game.start(nullptr);
+	g_game.setGameState(GAME_STATE_NORMAL);
+
+	std::vector<SimulatedPlayer> players;
+	addPlayerRows(options, *vocation, town->getTemplePosition(), players);
+
+	std::cout << ">> Logging in " << players.size() << " players" << std::endl;
+	for (SimulatedPlayer& simulated : players) {
+		g_dispatcher.addTask(createTask([&simulated]() { login(simulated); }));
+	}
+	simulation::advanceTime(simulation::getTime());
+
+	std::cout << ">> Simulating " << options.duration << " s" << std::endl;
+
+	const int64_t end = simulation::getTime() + options.duration * 1000;
+	const auto wallStart = std::chrono::steady_clock::now();
+	while (simulation::getTime() < end) {
+		const int64_t now = simulation::getTime();
+		for (SimulatedPlayer& simulated : players) {
+			if (simulated.nextAction > now) {
+				continue;
+			}
+
+			simulated.nextAction = now + options.actionInterval;
+			g_dispatcher.addTask(createTask([&simulated, &options]() { act(simulated, options); }));
+		}
+		simulation::advanceTime(std::min<int64_t>(now + options.step, end));
+	}
+	const std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - wallStart;
+
+	printReport(options, wallTime.count());
+
+	uint32_t relogins = 0;
+	for (const SimulatedPlayer& simulated : players) {
+		relogins += simulated.logins - 1;
+	}
+	std::cout << "relogins after death: " << relogins << std::endl;
+	printMemory("after the run");
+
+	// everything the players carried is freed, the pools should hand their empty slabs back
+	for (const SimulatedPlayer& simulated : players) {
+		g_dispatcher.addTask(createTask([&simulated]() { g_game.kickPlayer(simulated.playerId, false); }));
+	}
+	simulation::advanceTime(simulation::getTime() + 60 * 1000);
+	printMemory("60 s after logout");
+
+	g_game.setGameState(GAME_STATE_SHUTDOWN);
+	simulation::advanceTime(simulation::getTime());
+
+	g_workerPool.shutdown();
+	g_workerPool.join();
+	return 0;
+}
@@ -0,0 +1,184 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "simulation/virtualclock.h"
+#include "scheduler.h"
+#include "metrics.h"
+#include "tools.h"
+#include "tracing.h"
+
+#include <queue>
+#include <unordered_set>
+
+namespace {
+
+struct PendingEvent
+{
+	int64_t time;
+	uint64_t sequence;
+	SchedulerTask* task;
+};
+
+struct LaterEvent
+{
+	bool operator()(const PendingEvent& lhs, const PendingEvent& rhs) const {
+		if (lhs.time != rhs.time) {
+			return lhs.time > rhs.time;
+		}
+		// events due at the same time fire in the order they were added
+		return lhs.sequence > rhs.sequence;
+	}
+};
+
+// a fixed epoch (2020-01-01 UTC) keeps every timestamp of a seeded run the same
+int64_t virtualTime = 1577836800000;
+
+std::priority_queue<PendingEvent, std::vector<PendingEvent>, LaterEvent> pendingEvents;
+std::unordered_set<uint32_t> activeEvents;
+uint64_t eventSequence = 0;
+bool schedulerRunning = true;
+bool dispatcherRunning = true;
+
+}
+
+int64_t OTSYS_TIME()
+{
+	return virtualTime;
+}
+
+namespace simulation {
+
+int64_t getTime()
+{
+	return virtualTime;
+}
+
+void advanceTime(int64_t time)
+{
+	g_dispatcher.threadMain();
+
+	while (!pendingEvents.empty() && pendingEvents.top().time <= time) {
+		PendingEvent event = pendingEvents.top();
+		pendingEvents.pop();
+
+		if (activeEvents.erase(event.task->getEventId()) == 0) {
+			// stopped while pending
+			delete event.task;
+			continue;
+		}
+
+		virtualTime = std::max(virtualTime, event.time);
+		g_dispatcher.addTask(event.task);
+		g_dispatcher.threadMain();
+	}
+
+	virtualTime = std::max(virtualTime, time);
+}
+
+size_t getPendingEvents()
+{
+	return activeEvents.size();
+}
+
+}
+
+Task* createTask(TaskFunc&& f)
+{
+	return new Task(std::move(f));
+}
+
+Task* createTask(uint32_t expiration, TaskFunc&& f)
+{
+	return new Task(expiration, std::move(f));
+}
+
+void Dispatcher::threadMain()
+{
+	// runs until the queue is empty, including tasks added by the tasks themselves
+	std::vector<Task*> tmpTaskList;
+	while (!taskList.empty()) {
+		tmpTaskList.swap(taskList);
+
+		for (Task* task : tmpTaskList) {
+			if (!task->hasExpired()) {
+				++dispatcherCycle;
+				MetricTimer timer(g_metrics.dispatcherTaskRun);
+				TraceSpan span("task");
+				(*task)();
+			}
+			delete task;
+		}
+		tmpTaskList.clear();
+	}
+}
+
+void Dispatcher::addTask(Task* task)
+{
+	if (!dispatcherRunning) {
+		delete task;
+		return;
+	}
+
+	taskList.push_back(task);
+}
+
+void Dispatcher::shutdown()
+{
+	addTask(createTask([]() {
+		dispatcherRunning = false;
+	}));
+}
+
+uint32_t Scheduler::addEvent(SchedulerTask* task)
+{
+	if (!schedulerRunning) {
+		delete task;
+		return 0;
+	}
+
+	if (task->getEventId() == 0) {
+		task->setEventId(++lastEventId);
+	}
+
+	activeEvents.insert(task->getEventId());
+	pendingEvents.push({virtualTime + task->getDelay(), ++eventSequence, task});
+	return task->getEventId();
+}
+
+void Scheduler::stopEvent(uint32_t eventId)
+{
+	activeEvents.erase(eventId);
+}
+
+void Scheduler::shutdown()
+{
+	schedulerRunning = false;
+	activeEvents.clear();
+	while (!pendingEvents.empty()) {
+		delete pendingEvents.top().task;
+		pendingEvents.pop();
+	}
+}
+
+SchedulerTask* createSchedulerTask(uint32_t delay, TaskFunc&& f)
+{
+	return new SchedulerTask(delay, std::move(f));
+}
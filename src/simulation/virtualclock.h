@@ -0,0 +1,38 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_VIRTUALCLOCK_H_03D5F1B30806465EA8E59D5B4672C1FD
+#define FS_VIRTUALCLOCK_H_03D5F1B30806465EA8E59D5B4672C1FD
+
+// The simulation build links virtualclock.cpp instead of scheduler.cpp and
+// tasks.cpp, scheduler events then fire on a virtual clock that only moves
+// when advanceTime is called and dispatcher tasks run on the calling thread.
+namespace simulation {
+
+int64_t getTime();
+
+// runs every dispatcher task and every scheduler event due up to the given
+// time in due order, then leaves the clock at that time
+void advanceTime(int64_t time);
+
+size_t getPendingEvents();
+
+}
+
+#endif
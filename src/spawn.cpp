@@ -23,6 +23,7 @@
 #include "game.h"
 #include "monster.h"
 #include "configmanager.h"
+#include "metrics.h"
 #include "scheduler.h"
 
 #include "pugicast.h"
@@ -161,9 +162,12 @@ void Spawns::startup()
 
 void Spawns::clear()
 {
-	for (Spawn& spawn : spawnList) {
-		spawn.stopEvent();
+	if (checkEvent != 0) {
+		g_scheduler.stopEvent(checkEvent);
+		checkEvent = 0;
 	}
+	++checkGeneration;
+	checks = {};
 	spawnList.clear();
 
 	loaded = false;
@@ -181,10 +185,60 @@ bool Spawns::isInZone(const Position& centerPos, int32_t radius, const Position&
 			(pos.getY() >= centerPos.getY() - radius) && (pos.getY() <= centerPos.getY() + radius));
 }
 
+void Spawns::addCheck(Spawn* spawn, uint32_t spawnId, int64_t time)
+{
+	checks.emplace(time, spawn, spawnId);
+	if (!checking) {
+		scheduleChecks(time);
+	}
+}
+
+void Spawns::scheduleChecks(int64_t time)
+{
+	if (checkEvent != 0) {
+		if (checkEventTime <= time) {
+			return;
+		}
+		g_scheduler.stopEvent(checkEvent);
+	}
+
+	int64_t delay = std::max<int64_t>(time - OTSYS_TIME(), SCHEDULER_MINTICKS);
+	checkEventTime = time;
+	checkEvent = g_scheduler.addEvent(createSchedulerTask(delay, std::bind(&Spawns::checkSpawns, this, ++checkGeneration)));
+}
+
+void Spawns::checkSpawns(uint32_t generation)
+{
+	if (generation != checkGeneration) {
+		//replaced by an earlier check while it was already queued
+		return;
+	}
+
+	checkEvent = 0;
+
+	MetricTimer timer(g_metrics.spawnCheck);
+
+	//every check due by now runs as one batch
+	int64_t now = OTSYS_TIME();
+	checking = true;
+	++checkRound;
+	while (!checks.empty() && checks.top().time <= now) {
+		SpawnCheck check = checks.top();
+		checks.pop();
+		check.spawn->executeCheck(check.spawnId, now, checkRound);
+	}
+	checking = false;
+
+	if (!checks.empty()) {
+		scheduleChecks(checks.top().time);
+	}
+}
+
 void Spawn::startSpawnCheck()
 {
-	if (checkSpawnEvent == 0) {
-		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(getInterval(), std::bind(&Spawn::checkSpawn, this)));
+	if (!cleanupPending) {
+		cleanupPending = true;
+		g_game.map.spawns.addCheck(this, 0, OTSYS_TIME() + getInterval());
 	}
 }
 
@@ -199,6 +253,10 @@ Spawn::~Spawn()
 
 bool Spawn::findPlayer(const Position& pos)
 {
+	if (!g_game.map.hasPlayersAround(pos)) {
+		return false;
+	}
+
 	SpectatorVec spectators;
 	g_game.map.getSpectators(spectators, pos, false, true);
 	for (Creature* spectator : spectators) {
@@ -249,40 +307,49 @@ void Spawn::startup()
 	for (const auto& it : spawnMap) {
 		uint32_t spawnId = it.first;
 		const spawnBlock_t& sb = it.second;
-		spawnMonster(spawnId, sb.mType, sb.pos, sb.direction, true);
+		if (!spawnMonster(spawnId, sb.mType, sb.pos, sb.direction, true)) {
+			g_game.map.spawns.addCheck(this, spawnId, OTSYS_TIME() + sb.interval);
+		}
 	}
 }
 
-void Spawn::checkSpawn()
+void Spawn::executeCheck(uint32_t spawnId, int64_t now, uint32_t round)
 {
-	checkSpawnEvent = 0;
+	if (spawnId == 0) {
+		cleanupPending = false;
+		cleanup();
+		return;
+	}
 
-	cleanup();
+	if (spawnedMap.find(spawnId) != spawnedMap.end()) {
+		return;
+	}
 
-	uint32_t spawnCount = 0;
+	spawnBlock_t& sb = spawnMap[spawnId];
+	if (now < sb.lastSpawn + sb.interval) {
+		g_game.map.spawns.addCheck(this, spawnId, sb.lastSpawn + sb.interval);
+		return;
+	}
 
-	for (auto& it : spawnMap) {
-		uint32_t spawnId = it.first;
-		if (spawnedMap.find(spawnId) != spawnedMap.end()) {
-			continue;
-		}
+	if (findPlayer(sb.pos)) {
+		sb.lastSpawn = now;
+		g_game.map.spawns.addCheck(this, spawnId, now + sb.interval);
+		return;
+	}
 
-		spawnBlock_t& sb = it.second;
-		if (OTSYS_TIME() >= sb.lastSpawn + sb.interval) {
-			if (findPlayer(sb.pos)) {
-				sb.lastSpawn = OTSYS_TIME();
-				continue;
-			}
+	if (spawnRound != round) {
+		spawnRound = round;
+		spawnCount = 0;
+	}
 
-			spawnMonster(spawnId, sb.mType, sb.pos, sb.direction);
-			if (++spawnCount >= static_cast<uint32_t>(g_config.getNumber(ConfigManager::RATE_SPAWN))) {
-				break;
-			}
-		}
+	if (spawnCount >= static_cast<uint32_t>(g_config.getNumber(ConfigManager::RATE_SPAWN))) {
+		g_game.map.spawns.addCheck(this, spawnId, now + getInterval());
+		return;
 	}
 
-	if (spawnedMap.size() < spawnMap.size()) {
-		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(getInterval(), std::bind(&Spawn::checkSpawn, this)));
+	++spawnCount;
+	if (!spawnMonster(spawnId, sb.mType, sb.pos, sb.direction)) {
+		g_game.map.spawns.addCheck(this, spawnId, now + getInterval());
 	}
 }
 
@@ -294,12 +361,17 @@ void Spawn::cleanup()
 		Monster* monster = it->second;
 		if (monster->isRemoved()) {
 			if (spawnId != 0) {
-				spawnMap[spawnId].lastSpawn = OTSYS_TIME();
+				spawnBlock_t& sb = spawnMap[spawnId];
+				sb.lastSpawn = OTSYS_TIME();
+				g_game.map.spawns.addCheck(this, spawnId, sb.lastSpawn + sb.interval);
 			}
 
 			monster->decrementReferenceCounter();
 			it = spawnedMap.erase(it);
 		} else if (!isInSpawnZone(monster->getPosition()) && spawnId != 0) {
+			const spawnBlock_t& sb = spawnMap[spawnId];
+			g_game.map.spawns.addCheck(this, spawnId, sb.lastSpawn + sb.interval);
+
 			spawnedMap.insert(spawned_pair(0, monster));
 			it = spawnedMap.erase(it);
 		} else {
@@ -340,11 +412,3 @@ void Spawn::removeMonster(Monster* monster)
 		}
 	}
 }
-
-void Spawn::stopEvent()
-{
-	if (checkSpawnEvent != 0) {
-		g_scheduler.stopEvent(checkSpawnEvent);
-		checkSpawnEvent = 0;
-	}
-}
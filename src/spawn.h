@@ -23,6 +23,8 @@
 #include "tile.h"
 #include "position.h"
 
+#include <queue>
+
 class Monster;
 class MonsterType;
 class Npc;
@@ -54,7 +56,8 @@ class Spawn
 		void startup();
 
 		void startSpawnCheck();
-		void stopEvent();
+		// runs a check queued in Spawns, spawnId 0 is the cleanup of the spawned monsters
+		void executeCheck(uint32_t spawnId, int64_t now, uint32_t round);
 
 		bool isInSpawnZone(const Position& pos);
 		void cleanup();
@@ -72,11 +75,12 @@ class Spawn
 		int32_t radius;
 
 		uint32_t interval = 60000;
-		uint32_t checkSpawnEvent = 0;
+		uint32_t spawnRound = 0;
+		uint32_t spawnCount = 0;
+		bool cleanupPending = false;
 
 		static bool findPlayer(const Position& pos);
 		bool spawnMonster(uint32_t spawnId, MonsterType* mType, const Position& pos, Direction dir, bool startup = false);
-		void checkSpawn();
 };
 
 class Spawns
@@ -92,10 +96,34 @@ class Spawns
 			return started;
 		}
 
+		void addCheck(Spawn* spawn, uint32_t spawnId, int64_t time);
+
 	private:
+		struct SpawnCheck {
+			SpawnCheck(int64_t time, Spawn* spawn, uint32_t spawnId) : time(time), spawn(spawn), spawnId(spawnId) {}
+
+			bool operator<(const SpawnCheck& other) const {
+				return time > other.time;
+			}
+
+			int64_t time;
+			Spawn* spawn;
+			uint32_t spawnId;
+		};
+
+		void scheduleChecks(int64_t time);
+		void checkSpawns(uint32_t generation);
+
+		//pending checks of all spawns, the earliest on top
+		std::priority_queue<SpawnCheck> checks;
 		std::forward_list<Npc*> npcList;
 		std::forward_list<Spawn> spawnList;
 		std::string filename;
+		int64_t checkEventTime = 0;
+		uint32_t checkEvent = 0;
+		uint32_t checkGeneration = 0;
+		uint32_t checkRound = 0;
+		bool checking = false;
 		bool loaded = false;
 		bool started = false;
 };
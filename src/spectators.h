@@ -20,6 +20,7 @@
 #ifndef FS_SPECTATORS_H_D78A7CCB7080406E8CAA6B1D31D3DA71
 #define FS_SPECTATORS_H_D78A7CCB7080406E8CAA6B1D31D3DA71
 
+#include <unordered_set>
 #include <vector>
 
 class Creature;
@@ -35,12 +36,28 @@ public:
 	}
 
 	void addSpectators(const SpectatorVec& spectators) {
+		if (vec.empty()) {
+			vec = spectators.vec;
+			return;
+		}
+
+		// linear search is cheaper than hashing for the usual handful of spectators
+		if (vec.size() * spectators.size() <= 256) {
+			for (Creature* spectator : spectators.vec) {
+				auto it = std::find(vec.begin(), vec.end(), spectator);
+				if (it != end()) {
+					continue;
+				}
+				vec.emplace_back(spectator);
+			}
+			return;
+		}
+
+		std::unordered_set<Creature*> known(vec.begin(), vec.end());
 		for (Creature* spectator : spectators.vec) {
-			auto it = std::find(vec.begin(), vec.end(), spectator);
-			if (it != end()) {
-				continue;
+			if (known.insert(spectator).second) {
+				vec.emplace_back(spectator);
 			}
-			vec.emplace_back(spectator);
 		}
 	}
 
@@ -114,6 +114,11 @@ void Spells::clearMaps(bool fromLua)
 			++rune;
 		}
 	}
+
+	instantTrie.clear();
+	for (auto& it : instants) {
+		instantTrie.insert(it.first, &it.second);
+	}
 }
 
 void Spells::clear(bool fromLua)
@@ -150,6 +155,8 @@ bool Spells::registerEvent(Event_ptr event, const pugi::xml_node&)
 		auto result = instants.emplace(instant->getWords(), std::move(*instant));
 		if (!result.second) {
 			std::cout << "[Warning - Spells::registerEvent] Duplicate registered instant spell with words: " << instant->getWords() << std::endl;
+		} else {
+			instantTrie.insert(result.first->first, &result.first->second);
 		}
 		return result.second;
 	}
@@ -174,6 +181,8 @@ bool Spells::registerInstantLuaEvent(InstantSpell* event)
 		auto result = instants.emplace(instant->getWords(), std::move(*instant));
 		if (!result.second) {
 			std::cout << "[Warning - Spells::registerInstantLuaEvent] Duplicate registered instant spell with words: " << words << std::endl;
+		} else {
+			instantTrie.insert(result.first->first, &result.first->second);
 		}
 		return result.second;
 	}
@@ -231,20 +240,12 @@ RuneSpell* Spells::getRuneSpellByName(const std::string& name)
 
 InstantSpell* Spells::getInstantSpell(const std::string& words)
 {
+	// the deepest match wins, ties between words differing only in case go to the first in map order
 	InstantSpell* result = nullptr;
-
-	for (auto& it : instants) {
-		const std::string& instantSpellWords = it.second.getWords();
-		size_t spellLen = instantSpellWords.length();
-		if (strncasecmp(instantSpellWords.c_str(), words.c_str(), spellLen) == 0) {
-			if (!result || spellLen > result->getWords().length()) {
-				result = &it.second;
-				if (words.length() == spellLen) {
-					break;
-				}
-			}
-		}
-	}
+	instantTrie.forEachPrefix(words, [&result](size_t, const std::vector<WordTrie<InstantSpell>::Entry>& entries) {
+		result = entries.front().value;
+		return true;
+	});
 
 	if (result) {
 		const std::string& resultWords = result->getWords();
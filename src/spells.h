@@ -25,6 +25,7 @@
 #include "actions.h"
 #include "talkaction.h"
 #include "baseevents.h"
+#include "wordtrie.h"
 
 class InstantSpell;
 class RuneSpell;
@@ -74,6 +75,7 @@ class Spells final : public BaseEvents
 
 		std::map<uint16_t, RuneSpell> runes;
 		std::map<std::string, InstantSpell> instants;
+		WordTrie<InstantSpell> instantTrie;
 
 		friend class CombatSpell;
 		LuaScriptInterface scriptInterface { "Spell Interface" };
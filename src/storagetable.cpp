@@ -0,0 +1,109 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "storagetable.h"
+
+std::vector<StorageTable::Entry>::iterator StorageTable::lowerBound(uint32_t key)
+{
+	return std::lower_bound(entries.begin(), entries.end(), key, [](const Entry& entry, uint32_t key) { return entry.key < key; });
+}
+
+std::vector<StorageTable::Entry>::const_iterator StorageTable::lowerBound(uint32_t key) const
+{
+	return std::lower_bound(entries.begin(), entries.end(), key, [](const Entry& entry, uint32_t key) { return entry.key < key; });
+}
+
+bool StorageTable::get(uint32_t key, int32_t& value) const
+{
+	auto it = lowerBound(key);
+	if (it == entries.end() || it->key != key) {
+		value = -1;
+		return false;
+	}
+
+	value = it->value;
+	return true;
+}
+
+void StorageTable::set(uint32_t key, int32_t value)
+{
+	auto it = lowerBound(key);
+	if (it == entries.end() || it->key != key) {
+		it = entries.emplace(it, key, value);
+
+		auto erasedIt = std::find(erasedKeys.begin(), erasedKeys.end(), key);
+		if (erasedIt != erasedKeys.end()) {
+			*erasedIt = erasedKeys.back();
+			erasedKeys.pop_back();
+		}
+	} else if (it->value == value) {
+		return;
+	} else {
+		it->value = value;
+	}
+
+	if (!it->dirty) {
+		it->dirty = true;
+		++dirtyCount;
+	}
+}
+
+void StorageTable::erase(uint32_t key)
+{
+	auto it = lowerBound(key);
+	if (it == entries.end() || it->key != key) {
+		return;
+	}
+
+	if (it->dirty) {
+		--dirtyCount;
+	}
+
+	entries.erase(it);
+	erasedKeys.push_back(key);
+}
+
+void StorageTable::load(uint32_t key, int32_t value)
+{
+	// rows usually come in key order, so this is an append
+	if (entries.empty() || entries.back().key < key) {
+		entries.emplace_back(key, value);
+		return;
+	}
+
+	auto it = lowerBound(key);
+	if (it != entries.end() && it->key == key) {
+		it->value = value;
+	} else {
+		entries.emplace(it, key, value);
+	}
+}
+
+void StorageTable::clearDirty()
+{
+	if (dirtyCount != 0) {
+		for (Entry& entry : entries) {
+			entry.dirty = false;
+		}
+		dirtyCount = 0;
+	}
+	erasedKeys.clear();
+}
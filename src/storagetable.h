@@ -0,0 +1,68 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_STORAGETABLE_H_7C2E9A4B1D6F4E3A8B5C0D9E2F7A6B14
+#define FS_STORAGETABLE_H_7C2E9A4B1D6F4E3A8B5C0D9E2F7A6B14
+
+// Storage values of a player kept in a flat vector sorted by key, with the
+// keys changed since the last save tracked so only those are written back.
+class StorageTable
+{
+	public:
+		struct Entry {
+			Entry(uint32_t key, int32_t value) : key(key), value(value) {}
+
+			uint32_t key;
+			int32_t value;
+			bool dirty = false;
+		};
+
+		bool get(uint32_t key, int32_t& value) const;
+		void set(uint32_t key, int32_t value);
+		void erase(uint32_t key);
+
+		// stores a value read from the database, it is not marked dirty
+		void load(uint32_t key, int32_t value);
+
+		bool isDirty() const {
+			return dirtyCount != 0 || !erasedKeys.empty();
+		}
+		const std::vector<uint32_t>& getErasedKeys() const {
+			return erasedKeys;
+		}
+		// to be called once the dirty entries and erased keys are saved
+		void clearDirty();
+
+		std::vector<Entry>::const_iterator begin() const {
+			return entries.begin();
+		}
+		std::vector<Entry>::const_iterator end() const {
+			return entries.end();
+		}
+
+	private:
+		std::vector<Entry>::iterator lowerBound(uint32_t key);
+		std::vector<Entry>::const_iterator lowerBound(uint32_t key) const;
+
+		std::vector<Entry> entries;
+		std::vector<uint32_t> erasedKeys;
+		size_t dirtyCount = 0;
+};
+
+#endif
@@ -44,6 +44,11 @@ void TalkActions::clear(bool fromLua)
 		}
 	}
 
+	talkActionTrie.clear();
+	for (auto& it : talkActions) {
+		talkActionTrie.insert(it.first, &it.second);
+	}
+
 	reInitState(fromLua);
 }
 
@@ -72,9 +77,9 @@ bool TalkActions::registerEvent(Event_ptr event, const pugi::xml_node&)
 
 	for (size_t i = 0; i < words.size(); i++) {
 		if (i == words.size() - 1) {
-			talkActions.emplace(words[i], std::move(*talkAction));
+			addTalkAction(words[i], std::move(*talkAction));
 		} else {
-			talkActions.emplace(words[i], *talkAction);
+			addTalkAction(words[i], TalkAction(*talkAction));
 		}
 	}
 
@@ -88,65 +93,83 @@ bool TalkActions::registerLuaEvent(TalkAction* event)
 
 	for (size_t i = 0; i < words.size(); i++) {
 		if (i == words.size() - 1) {
-			talkActions.emplace(words[i], std::move(*talkAction));
+			addTalkAction(words[i], std::move(*talkAction));
 		} else {
-			talkActions.emplace(words[i], *talkAction);
+			addTalkAction(words[i], TalkAction(*talkAction));
 		}
 	}
 
 	return true;
 }
 
+void TalkActions::addTalkAction(const std::string& words, TalkAction&& talkAction)
+{
+	auto result = talkActions.emplace(words, std::move(talkAction));
+	if (result.second) {
+		talkActionTrie.insert(result.first->first, &result.first->second);
+	}
+}
+
 TalkActionResult_t TalkActions::playerSaySpell(Player* player, SpeakClasses type, const std::string& words) const
 {
-	size_t wordsLength = words.length();
-	for (auto it = talkActions.begin(); it != talkActions.end(); ) {
-		const std::string& talkactionWords = it->first;
-		size_t talkactionLength = talkactionWords.length();
-		if (wordsLength < talkactionLength || strncasecmp(words.c_str(), talkactionWords.c_str(), talkactionLength) != 0) {
-			++it;
-			continue;
+	// every words prefixing the text that end on a word boundary is a candidate,
+	// the first in map order whose separator accepts the parameter is executed
+	const size_t wordsLength = words.length();
+	const std::string* matchWords = nullptr;
+	const TalkAction* match = nullptr;
+	size_t paramStart = wordsLength;
+
+	talkActionTrie.forEachPrefix(words, [&](size_t length, const std::vector<WordTrie<TalkAction>::Entry>& entries) {
+		if (length != wordsLength && words[length] != ' ') {
+			return true;
 		}
 
-		std::string param;
-		if (wordsLength != talkactionLength) {
-			param = words.substr(talkactionLength);
-			if (param.front() != ' ') {
-				++it;
-				continue;
-			}
-			trim_left(param, ' ');
-
-			std::string separator = it->second.getSeparator();
-			if (separator != " ") {
-				if (!param.empty()) {
-					if (param != separator) {
-						++it;
-						continue;
-					} else {
-						param.erase(param.begin());
-					}
-				}
-			}
+		size_t start = words.find_first_not_of(' ', length);
+		if (start == std::string::npos) {
+			start = wordsLength;
 		}
 
-		if (it->second.fromLua) {
-			if (it->second.getNeedAccess() && !player->getGroup()->access) {
-				return TALKACTION_CONTINUE;
+		for (const auto& entry : entries) {
+			if (matchWords && *matchWords < *entry.words) {
+				break;
 			}
 
-			if (player->getAccountType() < it->second.getRequiredAccountType()) {
-				return TALKACTION_BREAK;
+			size_t entryParamStart = start;
+			const std::string& separator = entry.value->getSeparator();
+			if (separator != " " && start != wordsLength) {
+				if (words.compare(start, std::string::npos, separator) != 0) {
+					continue;
+				}
+				++entryParamStart;
 			}
+
+			matchWords = entry.words;
+			match = entry.value;
+			paramStart = entryParamStart;
+			break;
 		}
+		return true;
+	});
+
+	if (!match) {
+		return TALKACTION_CONTINUE;
+	}
 
-		if (it->second.executeSay(player, words, param, type)) {
+	if (match->fromLua) {
+		if (match->getNeedAccess() && !player->getGroup()->access) {
 			return TALKACTION_CONTINUE;
-		} else {
+		}
+
+		if (player->getAccountType() < match->getRequiredAccountType()) {
 			return TALKACTION_BREAK;
 		}
 	}
-	return TALKACTION_CONTINUE;
+
+	if (match->executeSay(player, words, words.substr(paramStart), type)) {
+		return TALKACTION_CONTINUE;
+	} else {
+		return TALKACTION_BREAK;
+	}
 }
 
 bool TalkAction::configureEvent(const pugi::xml_node& node)
@@ -23,6 +23,7 @@
 #include "luascript.h"
 #include "baseevents.h"
 #include "const.h"
+#include "wordtrie.h"
 
 class TalkAction;
 using TalkAction_ptr = std::unique_ptr<TalkAction>;
@@ -50,7 +51,7 @@ class TalkAction : public Event
 			words = word;
 			wordsMap.push_back(word);
 		}
-		std::string getSeparator() const {
+		const std::string& getSeparator() const {
 			return separator;
 		}
 		void setSeparator(std::string sep) {
@@ -107,7 +108,10 @@ class TalkActions final : public BaseEvents
 		Event_ptr getEvent(const std::string& nodeName) override;
 		bool registerEvent(Event_ptr event, const pugi::xml_node& node) override;
 
+		void addTalkAction(const std::string& words, TalkAction&& talkAction);
+
 		std::map<std::string, TalkAction> talkActions;
+		WordTrie<TalkAction> talkActionTrie;
 
 		LuaScriptInterface scriptInterface;
 };
@@ -21,6 +21,9 @@
 
 #include "tasks.h"
 #include "game.h"
+#include "lagwatchdog.h"
+#include "metrics.h"
+#include "tracing.h"
 
 extern Game g_game;
 
@@ -40,6 +43,8 @@ void Dispatcher::threadMain()
 	// NOTE: second argument defer_lock is to prevent from immediate locking
 	std::unique_lock<std::mutex> taskLockUnique(taskLock, std::defer_lock);
 
+	g_lagWatchdog.setDispatcherThread();
+
 	while (getState() != THREAD_STATE_TERMINATED) {
 		// check if there are tasks waiting
 		taskLockUnique.lock();
@@ -50,11 +55,21 @@ void Dispatcher::threadMain()
 		tmpTaskList.swap(taskList);
 		taskLockUnique.unlock();
 
+		g_metrics.dispatcherQueueDepth.set(tmpTaskList.size());
+
 		for (Task* task : tmpTaskList) {
 			if (!task->hasExpired()) {
 				++dispatcherCycle;
+				auto start = std::chrono::steady_clock::now();
+				g_metrics.dispatcherTaskWait.observe(std::chrono::duration_cast<std::chrono::microseconds>(start - task->queuedTime).count());
+				g_lagWatchdog.taskStarted(task, dispatcherCycle, start);
 				// execute it
-				(*task)();
+				{
+					TraceSpan span("task");
+					(*task)();
+				}
+				g_lagWatchdog.taskFinished();
+				g_metrics.dispatcherTaskRun.observe(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
 			}
 			delete task;
 		}
@@ -66,6 +81,8 @@ void Dispatcher::addTask(Task* task)
 {
 	bool do_signal = false;
 
+	task->queuedTime = std::chrono::steady_clock::now();
+
 	taskLock.lock();
 
 	if (getState() == THREAD_STATE_RUNNING) {
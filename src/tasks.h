@@ -52,14 +52,41 @@ class Task
 			return expiration < std::chrono::system_clock::now();
 		}
 
+		// player whose packet created the task, 0 for server tasks
+		void setPlayerId(uint32_t playerId) {
+			this->playerId = playerId;
+		}
+		uint32_t getPlayerId() const {
+			return playerId;
+		}
+
+		// static name of what the task runs, e.g. the Game method behind a packet
+		void setTag(const char* tag) {
+			this->tag = tag;
+		}
+		const char* getTag() const {
+			return tag;
+		}
+
+		// type of the wrapped callable, names the task in lag reports
+		const std::type_info& getType() const {
+			return func.target_type();
+		}
+
 	protected:
 		std::chrono::system_clock::time_point expiration = SYSTEM_TIME_ZERO;
 
 	private:
+		friend class Dispatcher;
+
 		// Expiration has another meaning for scheduler tasks,
 		// then it is the time the task should be added to the
 		// dispatcher
 		TaskFunc func;
+		// set when the task enters the dispatcher queue
+		std::chrono::steady_clock::time_point queuedTime;
+		uint32_t playerId = 0;
+		const char* tag = nullptr;
 };
 
 Task* createTask(TaskFunc&& f);
@@ -40,6 +40,8 @@ extern ConfigManager g_config;
 StaticTile real_nullptr_tile(0xFFFF, 0xFFFF, 0xFF);
 Tile& Tile::nullptr_tile = real_nullptr_tile;
 
+uint32_t TileDescriptionCache::currentGeneration = 1;
+
 bool Tile::hasProperty(ITEMPROPERTY prop) const
 {
 	if (ground && ground->hasProperty(prop)) {
@@ -75,6 +77,23 @@ bool Tile::hasProperty(const Item* exclude, ITEMPROPERTY prop) const
 	return false;
 }
 
+bool Tile::hasMoveEventItem(const Item* exclude) const
+{
+	if (ground && exclude != ground && g_moveEvents->isIndexedItem(ground)) {
+		return true;
+	}
+
+	if (const TileItemVector* items = getItemList()) {
+		for (const Item* item : *items) {
+			if (item != exclude && g_moveEvents->isIndexedItem(item)) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 bool Tile::hasHeight(uint32_t n) const
 {
 	uint32_t height = 0;
@@ -869,6 +888,7 @@ void Tile::addThing(int32_t, Thing* thing)
 		creature->setParent(this);
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
+		g_game.map.updateWalkMask(this);
 	} else {
 		Item* item = thing->getItem();
 		if (item == nullptr) {
@@ -881,6 +901,7 @@ void Tile::addThing(int32_t, Thing* thing)
 		}
 
 		item->setParent(this);
+		invalidateDescriptionCache();
 
 		const ItemType& itemType = Item::items[item->getID()];
 		if (itemType.isGroundTile()) {
@@ -981,6 +1002,8 @@ void Tile::updateThing(Thing* thing, uint16_t itemId, uint32_t count)
 		return /*RETURNVALUE_NOTPOSSIBLE*/;
 	}
 
+	invalidateDescriptionCache();
+
 	const ItemType& oldType = Item::items[item->getID()];
 	const ItemType& newType = Item::items[itemId];
 	resetTileFlags(item);
@@ -1050,6 +1073,7 @@ void Tile::replaceThing(uint32_t index, Thing* thing)
 
 	if (isInserted) {
 		item->setParent(this);
+		invalidateDescriptionCache();
 
 		resetTileFlags(oldItem);
 		setTileFlags(item);
@@ -1076,6 +1100,7 @@ void Tile::removeThing(Thing* thing, uint32_t count)
 				}
 
 				creatures->erase(it);
+				g_game.map.updateWalkMask(this);
 			}
 		}
 		return;
@@ -1091,6 +1116,8 @@ void Tile::removeThing(Thing* thing, uint32_t count)
 		return;
 	}
 
+	invalidateDescriptionCache();
+
 	if (item == ground) {
 		ground->setParent(nullptr);
 		ground = nullptr;
@@ -1158,6 +1185,9 @@ void Tile::removeThing(Thing* thing, uint32_t count)
 void Tile::removeCreature(Creature* creature)
 {
 	g_game.map.getQTNode(tilePos.x, tilePos.y)->removeCreature(creature);
+	if (creature->getPlayer()) {
+		g_game.map.removePlayerPresence(tilePos);
+	}
 	removeThing(creature, 0);
 }
 
@@ -1447,12 +1477,15 @@ void Tile::internalAddThing(uint32_t, Thing* thing)
 
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
+		g_game.map.updateWalkMask(this);
 	} else {
 		Item* item = thing->getItem();
 		if (item == nullptr) {
 			return;
 		}
 
+		invalidateDescriptionCache();
+
 		const ItemType& itemType = Item::items[item->getID()];
 		if (itemType.isGroundTile()) {
 			if (ground == nullptr) {
@@ -1546,6 +1579,12 @@ void Tile::setTileFlags(const Item* item)
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		setFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	if (g_moveEvents->isIndexedItem(item)) {
+		setFlag(TILESTATE_MOVEEVENTS);
+	}
+
+	g_game.map.updateWalkMask(this);
 }
 
 void Tile::resetTileFlags(const Item* item)
@@ -1607,6 +1646,12 @@ void Tile::resetTileFlags(const Item* item)
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		resetFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	if (hasFlag(TILESTATE_MOVEEVENTS) && !hasMoveEventItem(item)) {
+		resetFlag(TILESTATE_MOVEEVENTS);
+	}
+
+	g_game.map.updateWalkMask(this);
 }
 
 bool Tile::isMoveableBlocking() const
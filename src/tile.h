@@ -63,6 +63,7 @@ enum tileflags_t : uint32_t {
 	TILESTATE_IMMOVABLENOFIELDBLOCKPATH = 1 << 21,
 	TILESTATE_NOFIELDBLOCKPATH = 1 << 22,
 	TILESTATE_SUPPORTS_HANGABLE = 1 << 23,
+	TILESTATE_MOVEEVENTS = 1 << 24,
 
 	TILESTATE_FLOORCHANGE = TILESTATE_FLOORCHANGE_DOWN | TILESTATE_FLOORCHANGE_NORTH | TILESTATE_FLOORCHANGE_SOUTH | TILESTATE_FLOORCHANGE_EAST | TILESTATE_FLOORCHANGE_WEST | TILESTATE_FLOORCHANGE_SOUTH_ALT | TILESTATE_FLOORCHANGE_EAST_ALT,
 };
@@ -146,6 +147,37 @@ class TileItemVector : private ItemVector
 		uint16_t downItemCount = 0;
 };
 
+// Client bytes of the items a map description sends for a tile. Items are
+// viewer independent, so they are serialized once and copied into every
+// description until the tile's items change.
+struct TileDescriptionCache {
+	static constexpr uint8_t MAX_ITEMS = 10;
+	static constexpr uint8_t MAX_ITEM_SIZE = 5;
+
+	uint8_t bytes[MAX_ITEMS * MAX_ITEM_SIZE];
+	uint8_t ends[MAX_ITEMS]; // end offset of each item in bytes
+	uint8_t topCount = 0; // ground and top items
+	uint8_t downCount = 0;
+	uint32_t generation = 0; // valid while it matches currentGeneration
+
+	bool isValid() const {
+		return generation == currentGeneration;
+	}
+	void setValid() {
+		generation = currentGeneration;
+	}
+	void invalidate() {
+		generation = 0;
+	}
+
+	// item types changed (items reload), drop every tile's cache at once
+	static void invalidateAll() {
+		++currentGeneration;
+	}
+
+	static uint32_t currentGeneration;
+};
+
 class Tile : public Cylinder
 {
 	public:
@@ -205,6 +237,7 @@ class Tile : public Cylinder
 
 		bool hasProperty(ITEMPROPERTY prop) const;
 		bool hasProperty(const Item* exclude, ITEMPROPERTY prop) const;
+		bool hasMoveEventItem(const Item* exclude) const;
 
 		bool hasFlag(uint32_t flag) const {
 			return hasBitSet(flag, this->flags);
@@ -280,6 +313,19 @@ class Tile : public Cylinder
 		}
 		void setGround(Item* item) {
 			ground = item;
+			invalidateDescriptionCache();
+		}
+
+		TileDescriptionCache& getDescriptionCache() const {
+			if (!descriptionCache) {
+				descriptionCache.reset(new TileDescriptionCache);
+			}
+			return *descriptionCache;
+		}
+		void invalidateDescriptionCache() {
+			if (descriptionCache) {
+				descriptionCache->invalidate();
+			}
 		}
 
 	private:
@@ -292,6 +338,7 @@ class Tile : public Cylinder
 		void resetTileFlags(const Item* item);
 
 		Item* ground = nullptr;
+		mutable std::unique_ptr<TileDescriptionCache> descriptionCache;
 		Position tilePos;
 		uint32_t flags = 0;
 };
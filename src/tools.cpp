@@ -294,27 +294,86 @@ IntegerVector vectorAtoi(const StringVector& stringVector)
 	return returnVector;
 }
 
-std::mt19937& getRandomGenerator()
+void RandomGenerator::seed(uint64_t value)
 {
-	static std::random_device rd;
-	static std::mt19937 generator(rd());
+	// splitmix64 spreads the seed over the whole state, which must not be all zeros
+	for (uint64_t& word : state) {
+		value += 0x9E3779B97F4A7C15;
+		uint64_t z = value;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+		word = z ^ (z >> 31);
+	}
+}
+
+RandomGenerator& getRandomGenerator()
+{
+	thread_local RandomGenerator generator((static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}());
 	return generator;
 }
 
+void seedRandomGenerator(uint64_t seed)
+{
+	getRandomGenerator().seed(seed);
+}
+
+namespace {
+
+// Lemire's multiply and reject, unbiased and without a division in the common case
+uint32_t uniform_offset(RandomGenerator& generator, uint64_t range)
+{
+	uint32_t x = generator() >> 32;
+	if (range > std::numeric_limits<uint32_t>::max()) {
+		return x;
+	}
+
+	uint64_t m = static_cast<uint64_t>(x) * range;
+	uint32_t low = static_cast<uint32_t>(m);
+	if (low < range) {
+		const uint32_t threshold = static_cast<uint32_t>(-static_cast<uint32_t>(range)) % static_cast<uint32_t>(range);
+		while (low < threshold) {
+			x = generator() >> 32;
+			m = static_cast<uint64_t>(x) * range;
+			low = static_cast<uint32_t>(m);
+		}
+	}
+	return static_cast<uint32_t>(m >> 32);
+}
+
+}
+
 int32_t uniform_random(int32_t minNumber, int32_t maxNumber)
 {
-	static std::uniform_int_distribution<int32_t> uniformRand;
 	if (minNumber == maxNumber) {
 		return minNumber;
 	} else if (minNumber > maxNumber) {
 		std::swap(minNumber, maxNumber);
 	}
-	return uniformRand(getRandomGenerator(), std::uniform_int_distribution<int32_t>::param_type(minNumber, maxNumber));
+
+	const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(maxNumber) - minNumber) + 1;
+	return static_cast<int32_t>(minNumber + static_cast<int64_t>(uniform_offset(getRandomGenerator(), range)));
+}
+
+void uniform_random_fill(int32_t* out, size_t count, int32_t minNumber, int32_t maxNumber)
+{
+	if (minNumber == maxNumber) {
+		std::fill(out, out + count, minNumber);
+		return;
+	} else if (minNumber > maxNumber) {
+		std::swap(minNumber, maxNumber);
+	}
+
+	// same draws as count calls to uniform_random, with one generator lookup
+	RandomGenerator& generator = getRandomGenerator();
+	const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(maxNumber) - minNumber) + 1;
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = static_cast<int32_t>(minNumber + static_cast<int64_t>(uniform_offset(generator, range)));
+	}
 }
 
 int32_t normal_random(int32_t minNumber, int32_t maxNumber)
 {
-	static std::normal_distribution<float> normalRand(0.5f, 0.25f);
+	thread_local std::normal_distribution<float> normalRand(0.5f, 0.25f);
 	if (minNumber == maxNumber) {
 		return minNumber;
 	} else if (minNumber > maxNumber) {
@@ -336,8 +395,8 @@ int32_t normal_random(int32_t minNumber, int32_t maxNumber)
 
 bool boolean_random(double probability/* = 0.5*/)
 {
-	static std::bernoulli_distribution booleanRand;
-	return booleanRand(getRandomGenerator(), std::bernoulli_distribution::param_type(probability));
+	// the top 53 bits make a uniform double in [0, 1)
+	return (getRandomGenerator()() >> 11) * 0x1.0p-53 < probability;
 }
 
 void trimString(std::string& str)
@@ -1462,11 +1521,6 @@ const char* getReturnMessage(ReturnValue value)
 	}
 }
 
-int64_t OTSYS_TIME()
-{
-	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-}
-
 SpellGroup_t stringToSpellGroup(const std::string& value)
 {
 	std::string tmpStr = asLowerCaseString(value);
@@ -47,8 +47,53 @@ constexpr bool hasBitSet(uint32_t flag, uint32_t flags) {
 	return (flags & flag) != 0;
 }
 
-std::mt19937& getRandomGenerator();
+// xoshiro256** engine, every thread draws from its own instance
+class RandomGenerator
+{
+	public:
+		using result_type = uint64_t;
+
+		explicit RandomGenerator(uint64_t value) {
+			seed(value);
+		}
+
+		void seed(uint64_t value);
+
+		static constexpr result_type min() {
+			return 0;
+		}
+		static constexpr result_type max() {
+			return std::numeric_limits<result_type>::max();
+		}
+
+		result_type operator()() {
+			const uint64_t result = rotl(state[1] * 5, 7) * 9;
+			const uint64_t t = state[1] << 17;
+
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+			state[2] ^= t;
+			state[3] = rotl(state[3], 45);
+			return result;
+		}
+
+	private:
+		static constexpr uint64_t rotl(uint64_t x, int k) {
+			return (x << k) | (x >> (64 - k));
+		}
+
+		uint64_t state[4];
+};
+
+RandomGenerator& getRandomGenerator();
+// restarts the calling thread's stream, the same seed replays the same draws
+void seedRandomGenerator(uint64_t seed);
+
 int32_t uniform_random(int32_t minNumber, int32_t maxNumber);
+// fills out with count draws, for loops rolling many values at once
+void uniform_random_fill(int32_t* out, size_t count, int32_t minNumber, int32_t maxNumber);
 int32_t normal_random(int32_t minNumber, int32_t maxNumber);
 bool boolean_random(double probability = 0.5);
 
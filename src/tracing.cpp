@@ -0,0 +1,201 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "tracing.h"
+#include "scheduler.h"
+
+#include <fstream>
+
+namespace {
+
+constexpr size_t TRACE_BUFFER_CAPACITY = 32768;
+
+struct TraceEvent
+{
+	const char* name;
+	std::string detail;
+	std::chrono::steady_clock::time_point start;
+	std::chrono::steady_clock::time_point end;
+	uint32_t threadId;
+};
+
+void writeEscaped(std::ostream& os, const std::string& s)
+{
+	for (char c : s) {
+		switch (c) {
+			case '"': os << "\\\""; break;
+			case '\\': os << "\\\\"; break;
+			case '\n': os << "\\n"; break;
+			case '\t': os << "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					os << ' ';
+				} else {
+					os << c;
+				}
+				break;
+		}
+	}
+}
+
+void writeTrace(const std::string& fileName, const std::vector<TraceEvent>& events, std::chrono::steady_clock::time_point captureStart, size_t dropped)
+{
+	std::ofstream file(fileName);
+	if (!file.is_open()) {
+		std::cout << "[Error - Tracer::finishCapture] Unable to write " << fileName << std::endl;
+		return;
+	}
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	for (const TraceEvent& event : events) {
+		if (!first) {
+			file << ',';
+		}
+		first = false;
+
+		file << "\n{\"name\":\"" << event.name << "\",\"cat\":\"tfs\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId
+			<< ",\"ts\":" << std::chrono::duration_cast<std::chrono::microseconds>(event.start - captureStart).count()
+			<< ",\"dur\":" << std::chrono::duration_cast<std::chrono::microseconds>(event.end - event.start).count();
+		if (!event.detail.empty()) {
+			file << ",\"args\":{\"detail\":\"";
+			writeEscaped(file, event.detail);
+			file << "\"}";
+		}
+		file << '}';
+	}
+	file << "\n]}\n";
+
+	std::cout << ">> Trace with " << events.size() << " spans written to " << fileName;
+	if (dropped != 0) {
+		std::cout << ", " << dropped << " spans were overwritten";
+	}
+	std::cout << std::endl;
+}
+
+}
+
+class TraceBuffer
+{
+	public:
+		explicit TraceBuffer(uint32_t threadId) : threadId(threadId) {}
+
+		void add(const char* name, std::string detail, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+			std::lock_guard<std::mutex> lockClass(lock);
+			if (events.size() < TRACE_BUFFER_CAPACITY) {
+				events.push_back({name, std::move(detail), start, end, threadId});
+			} else {
+				events[next] = {name, std::move(detail), start, end, threadId};
+				++dropped;
+			}
+			next = (next + 1) % TRACE_BUFFER_CAPACITY;
+		}
+
+		void clear() {
+			std::lock_guard<std::mutex> lockClass(lock);
+			events.clear();
+			next = 0;
+			dropped = 0;
+		}
+
+		// moves the events recorded since the given time out of the buffer
+		size_t take(std::vector<TraceEvent>& out, std::chrono::steady_clock::time_point since) {
+			std::lock_guard<std::mutex> lockClass(lock);
+			for (TraceEvent& event : events) {
+				if (event.start >= since) {
+					out.push_back(std::move(event));
+				}
+			}
+			events.clear();
+			next = 0;
+			return dropped;
+		}
+
+	private:
+		std::mutex lock;
+		std::vector<TraceEvent> events;
+		size_t next = 0;
+		size_t dropped = 0;
+		uint32_t threadId;
+};
+
+Tracer::Tracer() = default;
+Tracer::~Tracer() = default;
+
+bool Tracer::startCapture(uint32_t duration)
+{
+	if (capturing.load(std::memory_order_relaxed)) {
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lockClass(buffersLock);
+		for (auto& buffer : buffers) {
+			buffer->clear();
+		}
+	}
+
+	captureStart = std::chrono::steady_clock::now();
+	capturing.store(true, std::memory_order_relaxed);
+
+	g_scheduler.addEvent(createSchedulerTask(duration, std::bind(&Tracer::finishCapture, this)));
+	return true;
+}
+
+void Tracer::record(const char* name, std::string detail, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+	getThreadBuffer().add(name, std::move(detail), start, end);
+}
+
+void Tracer::finishCapture()
+{
+	//dispatcher thread
+	capturing.store(false, std::memory_order_relaxed);
+
+	std::vector<TraceEvent> events;
+	size_t dropped = 0;
+	{
+		std::lock_guard<std::mutex> lockClass(buffersLock);
+		for (auto& buffer : buffers) {
+			dropped += buffer->take(events, captureStart);
+		}
+	}
+
+	std::sort(events.begin(), events.end(), [](const TraceEvent& lhs, const TraceEvent& rhs) {
+		return lhs.start < rhs.start;
+	});
+
+	// the file can take a while to write, keep it off the dispatcher
+	const std::string fileName = "trace_" + std::to_string(time(nullptr)) + ".json";
+	std::thread(writeTrace, fileName, std::move(events), captureStart, dropped).detach();
+}
+
+TraceBuffer& Tracer::getThreadBuffer()
+{
+	thread_local TraceBuffer* buffer = nullptr;
+	if (!buffer) {
+		// buffers outlive their threads so a capture never reads freed memory
+		std::lock_guard<std::mutex> lockClass(buffersLock);
+		buffers.emplace_back(new TraceBuffer(buffers.size() + 1));
+		buffer = buffers.back().get();
+	}
+	return *buffer;
+}
@@ -0,0 +1,99 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_TRACING_H_BD4FD32CD8384C4CA1F194CA8AE9130C
+#define FS_TRACING_H_BD4FD32CD8384C4CA1F194CA8AE9130C
+
+#include <atomic>
+
+// Spans are only recorded while a capture window is open, outside of one
+// a span costs a relaxed atomic load. Every thread records into its own
+// ring buffer, the newest events win when a window overflows it.
+
+class TraceBuffer;
+
+class Tracer
+{
+	public:
+		Tracer();
+		~Tracer();
+
+		// non-copyable
+		Tracer(const Tracer&) = delete;
+		Tracer& operator=(const Tracer&) = delete;
+
+		bool isCapturing() const {
+			return capturing.load(std::memory_order_relaxed);
+		}
+
+		// the trace is written to a Chrome trace-event file once the window closes,
+		// returns false if a window is already open
+		bool startCapture(uint32_t duration);
+
+		void record(const char* name, std::string detail, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+	private:
+		void finishCapture();
+		TraceBuffer& getThreadBuffer();
+
+		std::atomic<bool> capturing{false};
+		std::chrono::steady_clock::time_point captureStart;
+
+		std::mutex buffersLock;
+		std::vector<std::unique_ptr<TraceBuffer>> buffers;
+};
+
+extern Tracer g_tracer;
+
+class TraceSpan
+{
+	public:
+		explicit TraceSpan(const char* name) : name(name) {
+			if (g_tracer.isCapturing()) {
+				active = true;
+				start = std::chrono::steady_clock::now();
+			}
+		}
+		~TraceSpan() {
+			if (active) {
+				g_tracer.record(name, std::move(detail), start, std::chrono::steady_clock::now());
+			}
+		}
+
+		// non-copyable
+		TraceSpan(const TraceSpan&) = delete;
+		TraceSpan& operator=(const TraceSpan&) = delete;
+
+		// check before building a detail so spans outside a capture stay free
+		bool isActive() const {
+			return active;
+		}
+
+		void setDetail(std::string detail) {
+			this->detail = std::move(detail);
+		}
+
+	private:
+		const char* name;
+		std::string detail;
+		std::chrono::steady_clock::time_point start;
+		bool active = false;
+};
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_WORDTRIE_H_3C1E5A7B2D8F4E96A0B4C7D1E2F3A5B6
+#define FS_WORDTRIE_H_3C1E5A7B2D8F4E96A0B4C7D1E2F3A5B6
+
+// Case-insensitive prefix trie over the words of spells and talkactions.
+// Entries sharing the same words (ignoring case) are kept in the order of the
+// std::map they point into, so lookups resolve ties exactly like a map scan.
+template <typename T>
+class WordTrie
+{
+	public:
+		struct Entry {
+			const std::string* words;
+			T* value;
+		};
+
+		WordTrie() {
+			clear();
+		}
+
+		void clear() {
+			nodes.clear();
+			nodes.emplace_back();
+		}
+
+		void insert(const std::string& words, T* value) {
+			uint32_t index = 0;
+			for (char ch : words) {
+				index = getOrAddChild(index, toLower(ch));
+			}
+
+			std::vector<Entry>& entries = nodes[index].entries;
+			auto it = entries.begin();
+			while (it != entries.end() && *it->words < words) {
+				++it;
+			}
+			entries.insert(it, Entry{&words, value});
+		}
+
+		// calls func(length, entries) for every registered words that prefix the
+		// text, shortest first, until func returns false
+		template <typename Func>
+		void forEachPrefix(const std::string& text, Func&& func) const {
+			uint32_t index = 0;
+			for (size_t i = 0, length = text.length(); i < length; ++i) {
+				index = getChild(index, toLower(text[i]));
+				if (index == 0) {
+					return;
+				}
+
+				const std::vector<Entry>& entries = nodes[index].entries;
+				if (!entries.empty() && !func(i + 1, entries)) {
+					return;
+				}
+			}
+		}
+
+	private:
+		struct Node {
+			std::vector<std::pair<char, uint32_t>> children;
+			std::vector<Entry> entries;
+		};
+
+		static char toLower(char ch) {
+			return static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+		}
+
+		uint32_t getChild(uint32_t index, char ch) const {
+			for (const auto& child : nodes[index].children) {
+				if (child.first == ch) {
+					return child.second;
+				}
+			}
+			return 0;
+		}
+
+		uint32_t getOrAddChild(uint32_t index, char ch) {
+			uint32_t child = getChild(index, ch);
+			if (child != 0) {
+				return child;
+			}
+
+			child = nodes.size();
+			nodes.emplace_back();
+			nodes[index].children.emplace_back(ch, child);
+			return child;
+		}
+
+		std::vector<Node> nodes;
+};
+
+#endif
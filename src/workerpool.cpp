@@ -0,0 +1,112 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "workerpool.h"
+
+void WorkerPool::start(size_t threadCount)
+{
+	std::lock_guard<std::mutex> lockClass(jobLock);
+	running = true;
+	for (size_t i = 0; i < threadCount; ++i) {
+		threads.emplace_back(&WorkerPool::threadMain, this);
+	}
+}
+
+void WorkerPool::threadMain()
+{
+	uint64_t seenGeneration = 0;
+	std::unique_lock<std::mutex> jobLockUnique(jobLock);
+	while (true) {
+		jobSignal.wait(jobLockUnique, [&]() { return !running || seenGeneration != jobGeneration; });
+		if (!running) {
+			break;
+		}
+
+		seenGeneration = jobGeneration;
+		if (!job) {
+			// woke up after the caller already finished the job by itself
+			continue;
+		}
+
+		const JobFunc& func = *job;
+		size_t count = jobCount;
+		++activeWorkers;
+		jobLockUnique.unlock();
+
+		runJob(func, count);
+
+		jobLockUnique.lock();
+		if (--activeWorkers == 0) {
+			doneSignal.notify_one();
+		}
+	}
+}
+
+void WorkerPool::runJob(const JobFunc& func, size_t count)
+{
+	for (size_t i = nextIndex.fetch_add(1, std::memory_order_relaxed); i < count; i = nextIndex.fetch_add(1, std::memory_order_relaxed)) {
+		func(i);
+	}
+}
+
+void WorkerPool::parallelFor(size_t count, const JobFunc& func)
+{
+	if (threads.empty() || count <= 1) {
+		for (size_t i = 0; i < count; ++i) {
+			func(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lockClass(jobLock);
+		job = &func;
+		jobCount = count;
+		nextIndex.store(0, std::memory_order_relaxed);
+		++jobGeneration;
+	}
+	jobSignal.notify_all();
+
+	runJob(func, count);
+
+	std::unique_lock<std::mutex> jobLockUnique(jobLock);
+	doneSignal.wait(jobLockUnique, [this]() { return activeWorkers == 0; });
+	job = nullptr;
+}
+
+void WorkerPool::shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lockClass(jobLock);
+		running = false;
+	}
+	jobSignal.notify_all();
+}
+
+void WorkerPool::join()
+{
+	for (std::thread& thread : threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+	threads.clear();
+}
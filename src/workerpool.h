@@ -0,0 +1,69 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_WORKERPOOL_H_3B8E1D0A6C4F4B7E9A2D5C8F1E6B4A90
+#define FS_WORKERPOOL_H_3B8E1D0A6C4F4B7E9A2D5C8F1E6B4A90
+
+#include <atomic>
+#include <condition_variable>
+
+// Helper threads for fork-join work issued by the dispatcher, the world is
+// not modified while a job runs since the dispatcher waits for it.
+class WorkerPool
+{
+	public:
+		using JobFunc = std::function<void(size_t)>;
+
+		WorkerPool() = default;
+
+		// non-copyable
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		void start(size_t threadCount);
+		void shutdown();
+		void join();
+
+		size_t getThreadCount() const {
+			return threads.size();
+		}
+
+		// calls func for every index in [0, count), the caller takes part and returns once all calls are done
+		void parallelFor(size_t count, const JobFunc& func);
+
+	private:
+		void threadMain();
+		void runJob(const JobFunc& func, size_t count);
+
+		std::vector<std::thread> threads;
+		std::mutex jobLock;
+		std::condition_variable jobSignal;
+		std::condition_variable doneSignal;
+
+		const JobFunc* job = nullptr;
+		size_t jobCount = 0;
+		uint64_t jobGeneration = 0;
+		size_t activeWorkers = 0;
+		std::atomic<size_t> nextIndex{0};
+		bool running = false;
+};
+
+extern WorkerPool g_workerPool;
+
+#endif